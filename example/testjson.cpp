@@ -46,20 +46,17 @@ int main(int argc, char** argv)
     auto end = map.end();
     while (it < end)
     {
-        if (it->isUsed())
-        {
-            char const* key = map.getKey(it);
-            printf("'%s'\n", key);
-            printf("  isBool: %i\n", it->isBoolean());
-            printf("  isInt: %i\n", it->isInteger());
-            printf("  isDouble: %i\n", it->isDouble());
-            printf("  isString: %i\n", it->isString());
-            printf("  isArray: %i\n", it->isArray());
-            printf("  isMap: %i\n", it->isMap());
-            std::string val = *it;
-            printf("  value: %s\n", val.c_str());
-            printf("\n");
-        }
+        char const* key = map.getKey(it);
+        printf("'%s'\n", key);
+        printf("  isBool: %i\n", it->isBoolean());
+        printf("  isInt: %i\n", it->isInteger());
+        printf("  isDouble: %i\n", it->isDouble());
+        printf("  isString: %i\n", it->isString());
+        printf("  isArray: %i\n", it->isArray());
+        printf("  isMap: %i\n", it->isMap());
+        std::string val = *it;
+        printf("  value: %s\n", val.c_str());
+        printf("\n");
 
         ++it;
     }
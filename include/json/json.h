@@ -27,6 +27,8 @@
 #ifndef _JSON_JSON_H_
 #define _JSON_JSON_H_
 
+#include <stddef.h>
+
 #ifndef null
 #  if __cplusplus >= 201103L
 #    define null nullptr
@@ -35,9 +37,20 @@
 #  endif
 #endif /* null */
 
+/*
+ * Containers nested deeper than this are rejected with errorDepthLimit
+ * unless the reader is told otherwise.
+ */
+#ifndef JSON_MAX_DEPTH
+#  define JSON_MAX_DEPTH 1024
+#endif /* JSON_MAX_DEPTH */
+
 namespace json {
 
 struct Value;
+struct Number;
+class Arena;
+class KeyPool;
 class Map;
 class Array;
 using Uint = unsigned int;
@@ -51,9 +64,12 @@ protected:
     Value*          m_values = null;
     Uint*           m_codes = null;
     char**          m_keys = null;
-    Uint            m_num_buckets = 0;
+    bool*           m_borrowed = null;
+    Uint*           m_index = null;
+    unsigned char*  m_control = null;
     Uint            m_num_items = 0;
-    Uint            m_capacity = 0;
+    Uint            m_num_slots = 0;
+    bool            m_external = false;
 };
 
 struct ArrayBase
@@ -62,6 +78,99 @@ protected:
     Value*  m_data = null;
     Uint    m_num_items = 0;
     Uint    m_allocated_size = 0;
+    bool    m_external = false;
+};
+
+/*
+ * A string that is not owned and not necessarily NUL-terminated.
+ */
+struct StringView
+{
+    char const* data = null;
+    Uint        length = 0;
+
+    StringView() {}
+    StringView(char const* data_, Uint length_) : data(data_), length(length_) {}
+};
+
+/*
+ * A key taken from a KeyPool. Equal keys of one pool share their text, so
+ * maps compare them by pointer, and the hash code is computed only once.
+ */
+struct Key
+{
+    char const* data = null;
+    Uint        length = 0;
+    Uint        code = 0;
+};
+
+/*
+ * Result of a failed parse. Filling it in costs nothing but two stores, so
+ * the line and the column are only counted when somebody asks for them. The
+ * offset is as wide as a pointer, because BatchParser reports offsets into
+ * buffers larger than 4 GB.
+ */
+struct ParseError
+{
+    enum Code
+    {
+        errorNone,
+        errorUnexpectedEnd,
+        errorUnexpectedSymbol,
+        errorUnexpectedNull,
+        errorInvalidLiteral,
+        errorInvalidNumber,
+        errorInvalidEscape,
+        errorInvalidUtf8,
+        errorExpectedString,
+        errorExpectedColon,
+        errorUnterminatedComment,
+        errorDepthLimit,
+        errorTypeMismatch,
+        errorAborted
+    };
+
+    Code    code = errorNone;
+    size_t  offset = 0;
+
+    ParseError();
+    ParseError(Code code_, size_t offset_);
+
+    operator bool() const;
+    bool operator!() const;
+
+    char const* message() const;
+    void position(char const* first, Uint* line, Uint* column) const;
+    void clear();
+};
+
+/*
+ * Grammar policies for Reader and Value::parseData<>(). Every extension is a
+ * compile-time constant, so the strict instantiation has no code for them.
+ */
+struct StrictGrammar
+{
+    static constexpr bool allowComments = false;
+    static constexpr bool allowTrailingCommas = false;
+    static constexpr bool allowHexNumbers = false;
+    static constexpr bool allowExtraEscapes = false;
+    static constexpr bool allowExtraSpaces = false;
+    static constexpr bool allowControlCharacters = false;
+};
+
+/*
+ * Everything the parser has always accepted: comments, trailing commas, 0x
+ * integers, the \x and \v escapes, '\b', '\v' and '\f' as spaces and raw
+ * control characters inside strings.
+ */
+struct RelaxedGrammar
+{
+    static constexpr bool allowComments = true;
+    static constexpr bool allowTrailingCommas = true;
+    static constexpr bool allowHexNumbers = true;
+    static constexpr bool allowExtraEscapes = true;
+    static constexpr bool allowExtraSpaces = true;
+    static constexpr bool allowControlCharacters = true;
 };
 
 } /* namespace json */
@@ -89,5 +198,7 @@ protected:
 #include "jsonvalue.h"
 #include "jsonarray.h"
 #include "jsonmap.h"
+#include "jsonindex.h"
+#include "jsonnumber.h"
 
 #endif /* _JSON_JSON_H_ */
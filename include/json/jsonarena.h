@@ -0,0 +1,122 @@
+/*
+ * jsonarena.h
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef _JSON_JSONARENA_H_
+#define _JSON_JSONARENA_H_
+
+#include <stddef.h>
+
+#include "json.h"
+
+/*
+ * Size of the first heap block of an Arena; every next one is twice as large
+ * as the one before, up to 64 MiB.
+ */
+#ifndef JSON_ARENA_BLOCK_SIZE
+#  define JSON_ARENA_BLOCK_SIZE (64 * 1024)
+#endif /* JSON_ARENA_BLOCK_SIZE */
+
+namespace json {
+
+/*
+ * Monotonic allocator: memory is handed out by bumping a pointer and only
+ * given back all at once by release() or the destructor. It can start from
+ * a buffer of the caller and go on with heap blocks when that is used up;
+ * with huge_pages the blocks are mapped on 2 MiB pages where the system
+ * allows it.
+ *
+ * Containers and strings built in an arena do not own their memory, the
+ * same way as the borrowed ones of the in-situ mode: they never free it and
+ * move to the heap as soon as they have to grow without the arena.
+ */
+class Arena
+{
+public:
+    enum { alignment = 16 };
+
+    explicit Arena(size_t block_size = JSON_ARENA_BLOCK_SIZE, bool huge_pages = false);
+    Arena(void* buffer, size_t size);
+    ~Arena();
+
+    void* allocate(size_t size);
+    char* copyString(char const* str, Uint length);
+
+    /*
+     * Invalidates everything allocated so far. The caller's buffer, or else
+     * the last block, is kept for the next round.
+     */
+    void release();
+
+    size_t used() const;
+
+    /*
+     * Copies the used bytes of a block nobody owns into a new one of
+     * new_size bytes, taken from the arena or, if there is none, from the
+     * heap.
+     */
+    static void* relocate(Arena* arena, void const* block, size_t used, size_t new_size);
+
+private:
+    Arena(Arena const&) = delete;
+    Arena& operator=(Arena const&) = delete;
+
+    struct Block;
+
+    void* allocateSlow(size_t size);
+    Block* newBlock(size_t size);
+    void freeBlock(Block* block);
+
+private:
+    char*   m_start = null;
+    char*   m_current = null;
+    char*   m_end = null;
+    Block*  m_blocks = null;
+    char*   m_buffer = null;
+    size_t  m_buffer_size = 0;
+    size_t  m_block_size = 0;
+    size_t  m_next_block_size = 0;
+    size_t  m_used = 0;
+    bool    m_huge_pages = false;
+};
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+inline void* Arena::allocate(size_t size)
+{
+    size = (size + alignment - 1) & ~size_t(alignment - 1);
+
+    if (size > size_t(m_end - m_current))
+        return allocateSlow(size);
+
+    void* result = m_current;
+    m_current += size;
+
+    return result;
+}
+
+}  // namespace json
+
+
+#endif /* _JSON_JSONARENA_H_ */
@@ -32,10 +32,14 @@
 
 namespace json {
 
+/*
+ * An array given an arena takes its buffer from there and never frees it; it
+ * moves to the heap when it grows without the arena.
+ */
 class Array : protected ArrayBase
 {
 public:
-    Array(Uint initial_size = 0);
+    Array(Uint initial_size = 0, Arena* arena = null);
     Array(json::const_iterator first, json::const_iterator last);
     Array(std::initializer_list<Value> const& list);
     Array(Array const& other);
@@ -53,13 +57,14 @@ public:
     Uint reserved() const;
     Value* data() const;
 
-    void reserve(Uint new_size);
+    void reserve(Uint new_size, Arena* arena = null);
     void resize(Uint new_size);
 
     void insert(Uint index, Value const& value);
     void insert(Uint index, json::const_iterator first, json::const_iterator last);
 
     void append(Value const& value);
+    void append(Value&& value);
     void append(json::const_iterator first, json::const_iterator last);
 
     void prepend(Value const& value);
@@ -0,0 +1,111 @@
+/*
+ * jsonbatch.h
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef _JSON_JSONBATCH_H_
+#define _JSON_JSONBATCH_H_
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "json.h"
+
+namespace json {
+
+/*
+ * Parses a buffer holding many documents (one per line, or concatenated with
+ * optional RS separators as in RFC 7464) on a pool of threads. The documents
+ * are found in one quick pass, parsed in batches and returned in input order.
+ *
+ * The threads are started by the first parse() that needs them and wait for
+ * the next call until the parser is destroyed, so a stream of small buffers
+ * does not pay for creating threads every time. One parser must not be used
+ * by several threads at once. Any single document must be shorter than 4 GB.
+ */
+class BatchParser
+{
+public:
+    enum Format
+    {
+        formatLines,
+        formatConcatenated
+    };
+
+    enum ErrorPolicy
+    {
+        policyStop,
+        policySkip,
+        policyKeepEmpty
+    };
+
+    explicit BatchParser(Uint num_threads = 0, Uint batch_size = 256);
+    ~BatchParser();
+
+    void setFormat(Format format);
+    void setErrorPolicy(ErrorPolicy policy);
+    Format format() const;
+    ErrorPolicy errorPolicy() const;
+    Uint numThreads() const;
+
+    /*
+     * The error receives the first failure in input order whatever the
+     * policy; only policyStop makes the call fail, keeping the documents
+     * that precede the malformed one.
+     */
+    bool parse(char const* first, char const* last, std::vector<Value>* result, ParseError* error = null);
+    Uint numFailed() const;
+
+    static void findDocuments(char const* first, char const* last, Format format, std::vector<StringView>* result);
+
+private:
+    BatchParser(BatchParser const&) = delete;
+    BatchParser& operator=(BatchParser const&) = delete;
+
+    void run(std::function<void()> const& job, Uint num_threads);
+    void workerLoop(Uint generation);
+
+    Format      m_format = formatLines;
+    ErrorPolicy m_policy = policyStop;
+    Uint        m_num_threads = 0;
+    Uint        m_batch_size = 0;
+    Uint        m_num_failed = 0;
+
+    std::vector<std::thread>        m_workers;
+    std::mutex                      m_mutex;
+    std::condition_variable         m_wake;
+    std::condition_variable         m_done;
+    std::function<void()> const*    m_job = null;
+    Uint                            m_generation = 0;
+    Uint                            m_num_busy = 0;
+    bool                            m_stopping = false;
+};
+
+}  // namespace json
+
+
+#endif /* _JSON_JSONBATCH_H_ */
@@ -0,0 +1,653 @@
+/*
+ * jsonbind.h
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef _JSON_JSONBIND_H_
+#define _JSON_JSONBIND_H_
+
+#include <limits>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "json.h"
+#include "jsonreader.h"
+#include "jsonscanner.h"
+
+/*
+ * Binds the listed public members of a struct to the keys of the same names:
+ *
+ *     struct Point { int x; int y; std::vector<std::string> tags; };
+ *     JSON_BIND(Point, x, y, tags)
+ *
+ *     Point point;
+ *     json::parseData(first, last, &point, &error);
+ *     json::saveToString(point, &text);
+ *
+ * Place it in the namespace of the struct, after its definition. The names
+ * become a table built at compile time, and the members are read and written
+ * directly without a Value in between.
+ */
+#define JSON_BIND(Type, ...) \
+    inline ::json::StringView const* jsonFieldNames(Type const*, ::json::Uint* count) \
+    { \
+        static ::json::StringView const names[] = { JSON_BIND_FOR_EACH(JSON_BIND_NAME, __VA_ARGS__) }; \
+        *count = sizeof(names) / sizeof(names[0]); \
+        return names; \
+    } \
+    template<typename Function> \
+    inline bool jsonVisitField(Type& object, ::json::Uint ix, Function& function) \
+    { \
+        ::json::Uint n = 0; \
+        JSON_BIND_FOR_EACH(JSON_BIND_VISIT, __VA_ARGS__) \
+        return false; \
+    } \
+    template<typename Function> \
+    inline void jsonVisitFields(Type const& object, Function& function) \
+    { \
+        JSON_BIND_FOR_EACH(JSON_BIND_VISIT_ALL, __VA_ARGS__) \
+    }
+
+#define JSON_BIND_NAME(field) ::json::StringView(#field, sizeof(#field) - 1),
+#define JSON_BIND_VISIT(field) if (ix == n++) return function(object.field);
+#define JSON_BIND_VISIT_ALL(field) function(#field, sizeof(#field) - 1, object.field);
+
+#define JSON_BIND_EXPAND(x) x
+#define JSON_BIND_CONCAT(a, b) JSON_BIND_CONCAT_(a, b)
+#define JSON_BIND_CONCAT_(a, b) a##b
+#define JSON_BIND_COUNT(...) JSON_BIND_EXPAND(JSON_BIND_COUNT_(__VA_ARGS__, 32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1))
+#define JSON_BIND_COUNT_(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, _17, _18, _19, _20, _21, _22, _23, _24, _25, _26, _27, _28, _29, _30, _31, _32, N, ...) N
+#define JSON_BIND_FOR_EACH(m, ...) \
+    JSON_BIND_EXPAND(JSON_BIND_CONCAT(JSON_BIND_EACH_, JSON_BIND_COUNT(__VA_ARGS__))(m, __VA_ARGS__))
+
+#define JSON_BIND_EACH_1(m, x) m(x)
+#define JSON_BIND_EACH_2(m, x, ...) m(x) JSON_BIND_EXPAND(JSON_BIND_EACH_1(m, __VA_ARGS__))
+#define JSON_BIND_EACH_3(m, x, ...) m(x) JSON_BIND_EXPAND(JSON_BIND_EACH_2(m, __VA_ARGS__))
+#define JSON_BIND_EACH_4(m, x, ...) m(x) JSON_BIND_EXPAND(JSON_BIND_EACH_3(m, __VA_ARGS__))
+#define JSON_BIND_EACH_5(m, x, ...) m(x) JSON_BIND_EXPAND(JSON_BIND_EACH_4(m, __VA_ARGS__))
+#define JSON_BIND_EACH_6(m, x, ...) m(x) JSON_BIND_EXPAND(JSON_BIND_EACH_5(m, __VA_ARGS__))
+#define JSON_BIND_EACH_7(m, x, ...) m(x) JSON_BIND_EXPAND(JSON_BIND_EACH_6(m, __VA_ARGS__))
+#define JSON_BIND_EACH_8(m, x, ...) m(x) JSON_BIND_EXPAND(JSON_BIND_EACH_7(m, __VA_ARGS__))
+#define JSON_BIND_EACH_9(m, x, ...) m(x) JSON_BIND_EXPAND(JSON_BIND_EACH_8(m, __VA_ARGS__))
+#define JSON_BIND_EACH_10(m, x, ...) m(x) JSON_BIND_EXPAND(JSON_BIND_EACH_9(m, __VA_ARGS__))
+#define JSON_BIND_EACH_11(m, x, ...) m(x) JSON_BIND_EXPAND(JSON_BIND_EACH_10(m, __VA_ARGS__))
+#define JSON_BIND_EACH_12(m, x, ...) m(x) JSON_BIND_EXPAND(JSON_BIND_EACH_11(m, __VA_ARGS__))
+#define JSON_BIND_EACH_13(m, x, ...) m(x) JSON_BIND_EXPAND(JSON_BIND_EACH_12(m, __VA_ARGS__))
+#define JSON_BIND_EACH_14(m, x, ...) m(x) JSON_BIND_EXPAND(JSON_BIND_EACH_13(m, __VA_ARGS__))
+#define JSON_BIND_EACH_15(m, x, ...) m(x) JSON_BIND_EXPAND(JSON_BIND_EACH_14(m, __VA_ARGS__))
+#define JSON_BIND_EACH_16(m, x, ...) m(x) JSON_BIND_EXPAND(JSON_BIND_EACH_15(m, __VA_ARGS__))
+#define JSON_BIND_EACH_17(m, x, ...) m(x) JSON_BIND_EXPAND(JSON_BIND_EACH_16(m, __VA_ARGS__))
+#define JSON_BIND_EACH_18(m, x, ...) m(x) JSON_BIND_EXPAND(JSON_BIND_EACH_17(m, __VA_ARGS__))
+#define JSON_BIND_EACH_19(m, x, ...) m(x) JSON_BIND_EXPAND(JSON_BIND_EACH_18(m, __VA_ARGS__))
+#define JSON_BIND_EACH_20(m, x, ...) m(x) JSON_BIND_EXPAND(JSON_BIND_EACH_19(m, __VA_ARGS__))
+#define JSON_BIND_EACH_21(m, x, ...) m(x) JSON_BIND_EXPAND(JSON_BIND_EACH_20(m, __VA_ARGS__))
+#define JSON_BIND_EACH_22(m, x, ...) m(x) JSON_BIND_EXPAND(JSON_BIND_EACH_21(m, __VA_ARGS__))
+#define JSON_BIND_EACH_23(m, x, ...) m(x) JSON_BIND_EXPAND(JSON_BIND_EACH_22(m, __VA_ARGS__))
+#define JSON_BIND_EACH_24(m, x, ...) m(x) JSON_BIND_EXPAND(JSON_BIND_EACH_23(m, __VA_ARGS__))
+#define JSON_BIND_EACH_25(m, x, ...) m(x) JSON_BIND_EXPAND(JSON_BIND_EACH_24(m, __VA_ARGS__))
+#define JSON_BIND_EACH_26(m, x, ...) m(x) JSON_BIND_EXPAND(JSON_BIND_EACH_25(m, __VA_ARGS__))
+#define JSON_BIND_EACH_27(m, x, ...) m(x) JSON_BIND_EXPAND(JSON_BIND_EACH_26(m, __VA_ARGS__))
+#define JSON_BIND_EACH_28(m, x, ...) m(x) JSON_BIND_EXPAND(JSON_BIND_EACH_27(m, __VA_ARGS__))
+#define JSON_BIND_EACH_29(m, x, ...) m(x) JSON_BIND_EXPAND(JSON_BIND_EACH_28(m, __VA_ARGS__))
+#define JSON_BIND_EACH_30(m, x, ...) m(x) JSON_BIND_EXPAND(JSON_BIND_EACH_29(m, __VA_ARGS__))
+#define JSON_BIND_EACH_31(m, x, ...) m(x) JSON_BIND_EXPAND(JSON_BIND_EACH_30(m, __VA_ARGS__))
+#define JSON_BIND_EACH_32(m, x, ...) m(x) JSON_BIND_EXPAND(JSON_BIND_EACH_31(m, __VA_ARGS__))
+
+namespace json {
+
+/*
+ * Non-template part of the bindings and the pieces of the grammar they share.
+ */
+struct BindingBase
+{
+    static bool setMismatch(Scanner& scanner);
+    static Uint findField(StringView const* names, Uint count, StringView key, Uint hint);
+    static bool readUnsigned(char const* first, char const* last, unsigned long long* value);
+
+    static void writeString(std::string* result, char const* str, Uint length);
+    static void writeInteger(std::string* result, Integer value);
+    static void writeUnsigned(std::string* result, unsigned long long value);
+    static void writeDouble(std::string* result, double value);
+    static void writeValue(std::string* result, Value const& value);
+
+    template<typename Grammar>
+    static bool skipValue(Scanner& scanner, Uint depth);
+
+    template<typename Grammar>
+    static bool openContainer(Scanner& scanner, Uint depth, char close, bool* more);
+
+    template<typename Grammar>
+    static bool readKey(Scanner& scanner, StringView* key);
+
+    template<typename Grammar>
+    static bool nextItem(Scanner& scanner, char close, bool* more);
+
+private:
+    struct SkipHandler
+    {
+        bool onNull() { return true; }
+        bool onBool(bool) { return true; }
+        bool onInteger(Integer) { return true; }
+        bool onDouble(double) { return true; }
+        bool onString(StringView) { return true; }
+        bool onKey(StringView) { return true; }
+        bool onStartObject() { return true; }
+        bool onEndObject() { return true; }
+        bool onStartArray() { return true; }
+        bool onEndArray() { return true; }
+    };
+};
+
+/*
+ * How a type is read from and written to JSON. The primary template handles
+ * the structs declared with JSON_BIND; the specializations below cover bool,
+ * the arithmetic types, std::string, std::vector, std::map with string keys
+ * and Value. Other types can be bound by specializing it with the same two
+ * members. read() is called with the scanner on the first symbol of the
+ * value and leaves it right after the value; depth is the number of the
+ * containers around it.
+ */
+template<typename T, typename Enable = void>
+struct Binding : BindingBase
+{
+    template<typename Grammar>
+    static bool read(Scanner& scanner, Uint depth, T* object);
+    static void write(std::string* result, T const& object);
+
+private:
+    template<typename Grammar>
+    struct FieldReader
+    {
+        Scanner&    scanner;
+        Uint        depth;
+
+        template<typename F>
+        bool operator()(F& field)
+        {   return Binding<F>::template read<Grammar>(scanner, depth, &field); }
+    };
+
+    struct FieldWriter
+    {
+        std::string*    result;
+        bool            first;
+
+        template<typename F>
+        void operator()(char const* name, Uint length, F const& field)
+        {
+            result->append(first ? "\"" : ",\"");
+            result->append(name, length);
+            result->append("\":");
+            Binding<F>::write(result, field);
+            first = false;
+        }
+    };
+};
+
+template<>
+struct Binding<bool> : BindingBase
+{
+    template<typename Grammar>
+    static bool read(Scanner& scanner, Uint, bool* value)
+    {
+        char c = scanner.peek();
+
+        if (c != 't' and c != 'f')
+            return setMismatch(scanner);
+
+        if (not (c == 't' ? scanner.readLiteral("true", 4) : scanner.readLiteral("false", 5)))
+            return false;
+
+        *value = (c == 't');
+        return true;
+    }
+
+    static void write(std::string* result, bool value)
+    {   result->append(value ? "true" : "false"); }
+};
+
+template<typename T>
+struct Binding<T, typename std::enable_if<std::is_integral<T>::value and not std::is_same<T, bool>::value>::type> : BindingBase
+{
+    /*
+     * Integers past the range of Integer come out of the scanner as doubles;
+     * unsigned types read their digits once more to get them exactly.
+     */
+    template<typename Grammar>
+    static bool read(Scanner& scanner, Uint, T* value)
+    {
+        char c = scanner.peek();
+        char const* start = scanner.current();
+        Number number;
+        unsigned long long big = 0;
+
+        if (c != '-' and (c < '0' or c > '9'))
+            return setMismatch(scanner);
+
+        if (not scanner.readNumber<Grammar>(&number))
+            return false;
+
+        if (number.type == Number::typeInteger and fits(number.integer))
+            *value = static_cast<T>(number.integer);
+        else if (std::is_unsigned<T>::value and number.type == Number::typeDouble
+                 and readUnsigned(start, scanner.current(), &big) and big <= std::numeric_limits<T>::max())
+            *value = static_cast<T>(big);
+        else
+            return scanner.setError(ParseError::errorTypeMismatch);
+
+        return true;
+    }
+
+    static bool fits(Integer value)
+    {
+        if (std::is_signed<T>::value)
+            return value >= static_cast<Integer>(std::numeric_limits<T>::min())
+                and value <= static_cast<Integer>(std::numeric_limits<T>::max());
+
+        return value >= 0 and static_cast<unsigned long long>(value) <= std::numeric_limits<T>::max();
+    }
+
+    static void write(std::string* result, T value)
+    {
+        if (std::is_signed<T>::value)
+            writeInteger(result, static_cast<Integer>(value));
+        else
+            writeUnsigned(result, static_cast<unsigned long long>(value));
+    }
+};
+
+template<typename T>
+struct Binding<T, typename std::enable_if<std::is_floating_point<T>::value>::type> : BindingBase
+{
+    template<typename Grammar>
+    static bool read(Scanner& scanner, Uint, T* value)
+    {
+        char c = scanner.peek();
+        Number number;
+
+        if (c != '-' and (c < '0' or c > '9'))
+            return setMismatch(scanner);
+
+        if (not scanner.readNumber<Grammar>(&number))
+            return false;
+
+        *value = static_cast<T>(number.type == Number::typeInteger ? number.integer : number.real);
+        return true;
+    }
+
+    static void write(std::string* result, T value)
+    {   writeDouble(result, value); }
+};
+
+template<>
+struct Binding<std::string> : BindingBase
+{
+    template<typename Grammar>
+    static bool read(Scanner& scanner, Uint, std::string* value)
+    {
+        StringView str;
+
+        if (scanner.peek() != '"')
+            return setMismatch(scanner);
+
+        if (not scanner.readString<Grammar>(&str))
+            return false;
+
+        value->assign(str.data, str.length);
+        return true;
+    }
+
+    static void write(std::string* result, std::string const& value)
+    {   writeString(result, value.data(), value.size()); }
+};
+
+template<typename T, typename Allocator>
+struct Binding<std::vector<T, Allocator>> : BindingBase
+{
+    template<typename Grammar>
+    static bool read(Scanner& scanner, Uint depth, std::vector<T, Allocator>* value)
+    {
+        bool more = false;
+
+        if (scanner.peek() != '[')
+            return setMismatch(scanner);
+
+        if (not openContainer<Grammar>(scanner, depth, ']', &more))
+            return false;
+
+        value->clear();
+
+        while (more)
+        {
+            T item = T();
+
+            if (not Binding<T>::template read<Grammar>(scanner, depth + 1, &item))
+                return false;
+
+            value->push_back(std::move(item));
+
+            if (not nextItem<Grammar>(scanner, ']', &more))
+                return false;
+        }
+
+        return true;
+    }
+
+    static void write(std::string* result, std::vector<T, Allocator> const& value)
+    {
+        result->push_back('[');
+
+        for (auto it = value.begin(); it != value.end(); ++it)
+        {
+            if (it != value.begin())
+                result->push_back(',');
+
+            Binding<T>::write(result, *it);
+        }
+
+        result->push_back(']');
+    }
+};
+
+template<typename T, typename Compare, typename Allocator>
+struct Binding<std::map<std::string, T, Compare, Allocator>> : BindingBase
+{
+    using MapType = std::map<std::string, T, Compare, Allocator>;
+
+    template<typename Grammar>
+    static bool read(Scanner& scanner, Uint depth, MapType* value)
+    {
+        bool more = false;
+
+        if (scanner.peek() != '{')
+            return setMismatch(scanner);
+
+        if (not openContainer<Grammar>(scanner, depth, '}', &more))
+            return false;
+
+        value->clear();
+
+        while (more)
+        {
+            StringView key;
+
+            if (not readKey<Grammar>(scanner, &key))
+                return false;
+
+            T& member = (*value)[std::string(key.data, key.length)];
+
+            if (not Binding<T>::template read<Grammar>(scanner, depth + 1, &member))
+                return false;
+
+            if (not nextItem<Grammar>(scanner, '}', &more))
+                return false;
+        }
+
+        return true;
+    }
+
+    static void write(std::string* result, MapType const& value)
+    {
+        result->push_back('{');
+
+        for (auto it = value.begin(); it != value.end(); ++it)
+        {
+            if (it != value.begin())
+                result->push_back(',');
+
+            writeString(result, it->first.data(), it->first.size());
+            result->push_back(':');
+            Binding<T>::write(result, it->second);
+        }
+
+        result->push_back('}');
+    }
+};
+
+template<>
+struct Binding<Value> : BindingBase
+{
+    template<typename Grammar>
+    static bool read(Scanner& scanner, Uint depth, Value* value)
+    {
+        char const* start = scanner.current();
+
+        if (not skipValue<Grammar>(scanner, depth))
+            return false;
+
+        return value->parseData<Grammar>(start, scanner.current());
+    }
+
+    static void write(std::string* result, Value const& value)
+    {   writeValue(result, value); }
+};
+
+/*
+ * Reads a document into a bound type. On failure the object may be left
+ * partly filled. Keys without a member are checked and skipped, and members
+ * without a key keep their values.
+ */
+template<typename Grammar = RelaxedGrammar, typename T>
+bool parseData(char const* first, char const* last, T* object, ParseError* error = null);
+
+template<typename Grammar = RelaxedGrammar, typename T>
+bool parseString(std::string const& data, T* object, ParseError* error = null);
+
+/*
+ * Replaces the contents of result with the compact JSON text of object.
+ */
+template<typename T>
+void saveToString(T const& object, std::string* result);
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Grammar>
+bool BindingBase::skipValue(Scanner& scanner, Uint depth)
+{
+    SkipHandler handler;
+    Reader<SkipHandler, Grammar> reader(handler);
+
+    reader.setMaxDepth(depth < JSON_MAX_DEPTH ? JSON_MAX_DEPTH - depth : 0);
+
+    return reader.parseValue(scanner);
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*
+ * Steps over the opening bracket. more tells whether an item follows; the
+ * scanner is then on its first symbol.
+ */
+template<typename Grammar>
+bool BindingBase::openContainer(Scanner& scanner, Uint depth, char close, bool* more)
+{
+    if (depth >= JSON_MAX_DEPTH)
+        return scanner.setError(ParseError::errorDepthLimit);
+
+    scanner.advance();
+
+    if (not scanner.skipSpaces<Grammar>())
+        return scanner.setError(ParseError::errorUnexpectedEnd);
+
+    *more = (scanner.peek() != close);
+
+    if (not *more)
+        scanner.advance();
+
+    return true;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Grammar>
+bool BindingBase::readKey(Scanner& scanner, StringView* key)
+{
+    if (not scanner.readString<Grammar>(key))
+        return false;
+
+    if (not scanner.skipSpaces<Grammar>())
+        return scanner.setError(ParseError::errorUnexpectedEnd);
+
+    if (scanner.peek() != ':')
+        return scanner.setError(ParseError::errorExpectedColon);
+
+    scanner.advance();
+
+    if (not scanner.skipSpaces<Grammar>())
+        return scanner.setError(ParseError::errorUnexpectedEnd);
+
+    return true;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*
+ * Steps over the comma or the closing bracket after an item.
+ */
+template<typename Grammar>
+bool BindingBase::nextItem(Scanner& scanner, char close, bool* more)
+{
+    if (not scanner.skipSpaces<Grammar>())
+        return scanner.setError(ParseError::errorUnexpectedEnd);
+
+    *more = false;
+
+    if (scanner.peek() == ',')
+    {
+        scanner.advance();
+
+        if (not scanner.skipSpaces<Grammar>())
+            return scanner.setError(ParseError::errorUnexpectedEnd);
+
+        if (scanner.peek() != close)
+        {
+            *more = true;
+            return true;
+        }
+
+        if (not Grammar::allowTrailingCommas)
+            return scanner.setError(close == '}' ? ParseError::errorExpectedString : ParseError::errorUnexpectedSymbol);
+    }
+    else if (scanner.peek() != close)
+        return scanner.setError(ParseError::errorUnexpectedSymbol);
+
+    scanner.advance();
+    return true;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename T, typename Enable>
+template<typename Grammar>
+bool Binding<T, Enable>::read(Scanner& scanner, Uint depth, T* object)
+{
+    Uint count = 0;
+    StringView const* names = jsonFieldNames(static_cast<T const*>(null), &count);
+    FieldReader<Grammar> reader = { scanner, depth + 1 };
+    Uint hint = 0;
+    bool more = false;
+
+    if (scanner.peek() != '{')
+        return setMismatch(scanner);
+
+    if (not openContainer<Grammar>(scanner, depth, '}', &more))
+        return false;
+
+    while (more)
+    {
+        StringView key;
+
+        if (not readKey<Grammar>(scanner, &key))
+            return false;
+
+        Uint field = findField(names, count, key, hint);
+
+        if (field < count)
+        {
+            if (not jsonVisitField(*object, field, reader))
+                return false;
+
+            hint = field + 1;
+        }
+        else if (not skipValue<Grammar>(scanner, depth + 1))
+            return false;
+
+        if (not nextItem<Grammar>(scanner, '}', &more))
+            return false;
+    }
+
+    return true;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename T, typename Enable>
+void Binding<T, Enable>::write(std::string* result, T const& object)
+{
+    FieldWriter writer = { result, true };
+
+    result->push_back('{');
+    jsonVisitFields(object, writer);
+    result->push_back('}');
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Grammar, typename T>
+bool parseData(char const* first, char const* last, T* object, ParseError* error)
+{
+    Scanner scanner(first, last);
+
+    scanner.buildIndex<Grammar>();
+
+    if (not scanner.skipSpaces<Grammar>())
+        scanner.setError(ParseError::errorUnexpectedEnd);
+    else if (Binding<T>::template read<Grammar>(scanner, 0, object))
+    {
+        if (not scanner.skipSpaces<Grammar>() and not scanner.failed())
+            return true;
+
+        scanner.setError(ParseError::errorUnexpectedSymbol);
+    }
+
+    if (error)
+        scanner.getError(error);
+
+    return false;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Grammar, typename T>
+bool parseString(std::string const& data, T* object, ParseError* error)
+{
+    return parseData<Grammar>(data.data(), data.data() + data.size(), object, error);
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename T>
+void saveToString(T const& object, std::string* result)
+{
+    result->clear();
+    Binding<T>::write(result, object);
+}
+
+}  // namespace json
+
+
+#endif /* _JSON_JSONBIND_H_ */
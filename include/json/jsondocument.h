@@ -0,0 +1,103 @@
+/*
+ * jsondocument.h
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef _JSON_JSONDOCUMENT_H_
+#define _JSON_JSONDOCUMENT_H_
+
+#include <string>
+
+#include "json.h"
+#include "jsonarena.h"
+#include "jsonkeypool.h"
+
+namespace json {
+
+/*
+ * A parsed tree that lives entirely in its own arena: every array, map slot,
+ * key and string comes from there, so a parse makes a handful of heap calls
+ * instead of thousands and the destructor drops the tree without visiting
+ * it. The tree is read-only; copies taken from it are ordinary values.
+ *
+ * A document that is parsed again reuses the memory of the previous parse.
+ *
+ * Keys are stored once per document in its own key pool, or in a pool shared
+ * with other documents; lookups with keys of that pool skip hashing.
+ */
+class Document
+{
+public:
+    explicit Document(size_t block_size = JSON_ARENA_BLOCK_SIZE, bool huge_pages = false);
+    Document(void* buffer, size_t size);
+    ~Document();
+
+    template<typename Grammar = RelaxedGrammar>
+    bool parse(char const* first, char const* last, ParseError* error = null, bool raw_numbers = false);
+
+    /*
+     * Strings and keys point into the buffer, as with Value::parseDataInSitu(),
+     * so it must outlive the document.
+     */
+    template<typename Grammar = RelaxedGrammar>
+    bool parseInSitu(char* first, char* last, ParseError* error = null, bool raw_numbers = false);
+
+    bool parseString(std::string const& data, ParseError* error = null, bool raw_numbers = false);
+
+    /*
+     * Keeps a single copy of every distinct string value in the arena while
+     * parsing. Pays off on data with many repeated values; strings of up to
+     * 8 bytes are stored inside their values anyway.
+     */
+    void setInternStrings(bool intern);
+    bool internStrings() const;
+
+    /*
+     * A shared pool, KeyPool::global() for example, must outlive the
+     * document; null goes back to the pool of the document.
+     */
+    void setKeyPool(KeyPool* pool);
+    KeyPool& keyPool();
+
+    Value const& root() const;
+    Arena const& arena() const;
+
+    void clear();
+
+private:
+    Document(Document const&) = delete;
+    Document& operator=(Document const&) = delete;
+
+private:
+    Arena       m_arena;
+    Value       m_root;
+    KeyPool     m_keys;
+    KeyPool*    m_shared_keys = null;
+    bool        m_intern_strings = false;
+};
+
+}  // namespace json
+
+
+#endif /* _JSON_JSONDOCUMENT_H_ */
@@ -0,0 +1,82 @@
+/*
+ * jsonindex.h
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef _JSON_JSONINDEX_H_
+#define _JSON_JSONINDEX_H_
+
+#include "json.h"
+
+namespace json {
+
+/*
+ * Positions of all structural tokens of a document, found 64 bytes at a time:
+ * the characters '{', '}', '[', ']', ':', ',' outside of strings, the opening
+ * quote of every string and the first byte of every other token (numbers,
+ * literals, garbage). The list is terminated by the length of the document.
+ *
+ * What counts as a space follows the grammar. Comments, where the grammar
+ * allows them, are followed the way Scanner skips them and only their first
+ * '/' is indexed; elsewhere a '/' is garbage like any other. plain() is false when the input has a comment, or a '/' or a
+ * '\\' outside of strings: readers that walk nothing but the index, rather
+ * than the input at its positions, take the index only when it is plain.
+ */
+class StructuralIndex
+{
+public:
+    StructuralIndex();
+    StructuralIndex(StructuralIndex&& other);
+    ~StructuralIndex();
+    StructuralIndex& operator=(StructuralIndex&& other);
+
+    template<typename Grammar = RelaxedGrammar>
+    bool build(char const* first, char const* last);
+    void swap(StructuralIndex& other);
+    void clear();
+
+    bool empty() const;
+    bool plain() const;
+    Uint numItems() const;
+    Uint const* data() const;
+    Uint const* begin() const;
+    Uint const* end() const;
+
+private:
+    StructuralIndex(StructuralIndex const&) = delete;
+    StructuralIndex& operator=(StructuralIndex const&) = delete;
+
+    void reserve(Uint new_size);
+
+private:
+    Uint*   m_data = null;
+    Uint    m_num_items = 0;
+    Uint    m_allocated_size = 0;
+    bool    m_plain = true;
+};
+
+}  // namespace json
+
+
+#endif /* _JSON_JSONINDEX_H_ */
@@ -0,0 +1,99 @@
+/*
+ * jsonkeypool.h
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef _JSON_JSONKEYPOOL_H_
+#define _JSON_JSONKEYPOOL_H_
+
+#include <mutex>
+#include <vector>
+
+#include "json.h"
+#include "jsonarena.h"
+
+namespace json {
+
+/*
+ * Stores every distinct key once, together with its length and the hash code
+ * used by Map. Maps built from the keys of a pool borrow them, so the pool
+ * must outlive them; lookups with a Key skip hashing and usually stop at a
+ * pointer comparison.
+ *
+ * The texts are taken from the arena given to the constructor, which must
+ * outlive the pool, or from an arena of the pool itself. Keys are only ever
+ * dropped all at once by clear().
+ */
+class KeyPool
+{
+public:
+    explicit KeyPool(Arena* arena = null, bool synchronized = false);
+
+    Key intern(char const* str, Uint length);
+    Key intern(char const* str);
+
+    /*
+     * A key that was never interned comes back with null data; no map built
+     * from this pool has it.
+     */
+    Key find(char const* str, Uint length) const;
+    Key find(char const* str) const;
+
+    Uint numKeys() const;
+
+    /*
+     * Forgets every key. The memory of the texts goes back to the pool's own
+     * arena; an arena of the caller has to be released by the caller. No map
+     * or document may still refer to the pool, since their keys would dangle.
+     */
+    void clear();
+
+    /*
+     * The process-wide pool. Unlike the others it can be used by several
+     * threads at once, and it lives until the end of the process; clear()
+     * refuses to empty it.
+     */
+    static KeyPool& global();
+
+private:
+    KeyPool(KeyPool const&) = delete;
+    KeyPool& operator=(KeyPool const&) = delete;
+
+    Key const* lookup(char const* str, Uint length, Uint code) const;
+    void grow();
+
+private:
+    Arena               m_own_arena;
+    Arena*              m_arena = null;
+    std::vector<Key>    m_keys;
+    Uint                m_num_keys = 0;
+    bool                m_synchronized = false;
+    mutable std::mutex  m_mutex;
+};
+
+}  // namespace json
+
+
+#endif /* _JSON_JSONKEYPOOL_H_ */
@@ -0,0 +1,144 @@
+/*
+ * jsonlazy.h
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef _JSON_JSONLAZY_H_
+#define _JSON_JSONLAZY_H_
+
+#include <string>
+#include <vector>
+
+#include "json.h"
+
+namespace json {
+
+class LazyDocument;
+
+/*
+ * A value inside a LazyDocument: a position in its structural index. Nothing
+ * is converted until one of the as...() methods or toValue() is called, and a
+ * key or index that is not there gives an untyped value, so lookups chain.
+ */
+class LazyValue
+{
+public:
+    LazyValue();
+
+    Value::Type type() const;
+    bool isUsed() const;
+    bool isNull() const;
+    bool isBoolean() const;
+    bool isInteger() const;
+    bool isDouble() const;
+    bool isString() const;
+    bool isArray() const;
+    bool isMap() const;
+
+    Uint size() const;
+
+    bool hasKey(char const* key) const;
+    bool hasKey(std::string const& key) const;
+
+    LazyValue operator[](char const* key) const;
+    LazyValue operator[](std::string const& key) const;
+    LazyValue operator[](int ix) const;
+
+    bool        asBoolean() const;
+    Integer     asInteger() const;
+    double      asDouble() const;
+    std::string asString() const;
+
+    StringView  raw() const;
+    Value       toValue() const;
+
+private:
+    friend class LazyDocument;
+
+    LazyValue(LazyDocument const* document, Uint entry);
+
+    LazyValue find(char const* key, Uint length) const;
+
+private:
+    LazyDocument const* m_document = null;
+    Uint                m_entry = 0;
+};
+
+/*
+ * Keeps the input and its structural index; only the brackets are matched up
+ * front, the rest is checked when it is reached. The input must outlive the
+ * document unless it had comments, which are blanked out in a private copy.
+ *
+ * parse<StrictGrammar>() rejects comments without copying anything and
+ * converts the values it reaches by the strict grammar; the plain parse() is
+ * RelaxedGrammar.
+ */
+class LazyDocument
+{
+public:
+    LazyDocument();
+    ~LazyDocument();
+
+    bool parse(char const* first, char const* last, ParseError* error = null);
+    bool parse(std::string const& data, ParseError* error = null);
+    void clear();
+
+    template<typename Grammar>
+    bool parse(char const* first, char const* last, ParseError* error = null);
+
+    LazyValue root() const;
+    LazyValue operator[](char const* key) const;
+    LazyValue operator[](std::string const& key) const;
+    LazyValue operator[](int ix) const;
+
+private:
+    friend class LazyValue;
+
+    LazyDocument(LazyDocument const&) = delete;
+    LazyDocument& operator=(LazyDocument const&) = delete;
+
+    bool matchBrackets(ParseError* error);
+    bool indexFailed(ParseError* error);
+    bool setError(ParseError* error, ParseError::Code code, Uint offset);
+
+    char at(Uint entry) const;
+    Uint position(Uint entry) const;
+    bool isValue(Uint entry) const;
+    Uint skip(Uint entry) const;
+    Uint end(Uint entry) const;
+    bool keyEquals(Uint entry, char const* key, Uint length) const;
+
+private:
+    char const*         m_first = null;
+    char const*         m_last = null;
+    char*               m_buffer = null;
+    bool                m_strict = false;
+    StructuralIndex     m_index;
+    std::vector<Uint>   m_match;
+};
+
+}  // namespace json
+
+
+#endif /* _JSON_JSONLAZY_H_ */
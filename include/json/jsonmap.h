@@ -38,15 +38,31 @@
 namespace json {
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
+/*
+ * The items are kept densely in insertion order, which is also the order of
+ * iteration, and found through a separate index: open addressing with
+ * linear probing over a power-of-two number of slots, each holding the
+ * number of an item. Every slot has a control byte, empty or seven bits of
+ * the hash code, and a probe compares the bytes of 16 slots at once, so the
+ * keys themselves are only touched on a likely match. Removal shifts the
+ * rest of the probe run back instead of leaving tombstones, and the later
+ * items down, renumbering each of them through its own probe run: the cost
+ * grows with the number of items after the removed one, and removing the
+ * last item takes constant time.
+ *
+ * A map given an arena takes its slots from there and never frees them; it
+ * moves to the heap when it grows without the arena. Borrowed keys are not
+ * copied and must outlive the map.
+ */
 class Map : protected MapBase
 {
 public:
-    static const Uint bucket_size = 6;
+    static const Uint group_size = 16;
 
     typedef json::iterator  iterator;
     typedef json::const_iterator    const_iterator;
 
-    Map(Uint initial_buckets_count = 0);
+    Map(Uint initial_size = 0, Arena* arena = null);
     Map(std::initializer_list<std::pair<char const*, Value>> const& list);
     Map(Map&& other);
     Map(Map const& other);
@@ -60,10 +76,19 @@ public:
     void assign(Map const& other);
 
     Uint numItems() const;
+
+    /*
+     * The number of items the map holds before it grows.
+     */
     Uint capacity() const;
-    Uint numBuckets() const;
+
+    /*
+     * Makes room for num_items items without growing again.
+     */
+    void reserve(Uint num_items, Arena* arena = null);
 
     bool hasKey(char const* key) const;
+    bool hasKey(Key const& key) const;
     void getKeys(std::vector<char const*>* result) const;
     char const* getKey(json::const_iterator iter) const;
 
@@ -71,33 +96,47 @@ public:
     void replace(char const* key, Value const& value);
     void insert(char const* key, Value const& value);
     void insert(std::string const& key, Value const& value);
+    Value& insertBorrowed(char const* key, Arena* arena = null);
+    Value& insertBorrowed(Key const& key, Arena* arena = null);
 
+    /*
+     * The Key versions skip hashing; a key they insert is copied all the
+     * same.
+     */
     Value& operator[](char const* key);
     Value& operator[](std::string const& key);
+    Value& operator[](Key const& key);
     Value const& operator[](char const* key) const;
     Value const& operator[](std::string const& key) const;
+    Value const& operator[](Key const& key) const;
 
     json::iterator begin();
     json::iterator end();
     json::const_iterator begin() const;
     json::const_iterator end() const;
 
+    static Uint hashCode(char const* str, Uint length);
+
 private:
-    void setBucketsCount(Uint new_buckets_count);
-    Value* insertRaw(Uint hash, char const* key, Value* value);
+    void allocate(Uint num_slots, Arena* arena);
+    void rehash(Uint num_slots, Arena* arena = null);
+    Value* insertRaw(Uint hash, char const* key, Value* value, bool borrowed = false, Arena* arena = null);
     Value const* find(char const* key) const;
     Value const* find(Uint hash, char const* key) const;
+    Uint findSlot(Uint hash, char const* key) const;
+    Uint findFree(Uint hash) const;
+    Uint findIndex(Uint hash, Uint index) const;
+    void erase(Uint slot);
 
-    void hashCodeToIndex(Uint hash_key, Uint* first, Uint *last) const;
-
-    void setKey(Uint index, char const* key, Uint code);
+    void setControl(Uint index, unsigned char control);
+    void setKey(Uint index, char const* key, Uint code, bool borrowed = false);
     void clear(Uint index);
     bool itemEqual(Uint index, Uint hash, char const* key) const;
-    bool itemIsUsed(Uint index) const;
 
     static Uint getHashCode(char const* str);
     static bool strEquals(char const* s1, char const* s2);
-    static Uint getIndex(Uint bucket_index, Uint item_index);
+    static Uint mixCode(Uint code);
+    static Uint slotsFor(Uint num_items);
 };
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
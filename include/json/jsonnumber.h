@@ -0,0 +1,74 @@
+/*
+ * jsonnumber.h
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef _JSON_JSONNUMBER_H_
+#define _JSON_JSONNUMBER_H_
+
+#include "json.h"
+
+namespace json {
+
+/*
+ * A number converted in the same pass that validates it against the JSON
+ * grammar. Integers that do not fit into Integer become doubles; doubles are
+ * rounded correctly and never depend on the current locale.
+ */
+struct Number
+{
+    enum Type
+    {
+        typeInteger,
+        typeDouble
+    };
+
+    Type    type = typeInteger;
+    Integer integer = 0;
+    double  real = 0.0;
+
+    static char const* parse(char const* first, char const* last, Number* result);
+    static char const* parseHex(char const* first, char const* last, Number* result);
+
+    enum { formatSize = 32 };
+
+    /*
+     * The grammar of parse() without the conversion: the end of the number,
+     * or null if it is malformed. The type, if asked for, is the one parse()
+     * would give.
+     */
+    static char const* skip(char const* first, char const* last, Type* type = null);
+
+    /*
+     * Writes the shortest text that parse() reads back as the same double into
+     * a buffer of formatSize bytes, not terminated, and returns its length.
+     * JSON has no infinities and NaN, so they are written as null.
+     */
+    static Uint format(double value, char* result);
+};
+
+}  // namespace json
+
+
+#endif /* _JSON_JSONNUMBER_H_ */
@@ -0,0 +1,90 @@
+/*
+ * jsonprojection.h
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef _JSON_JSONPROJECTION_H_
+#define _JSON_JSONPROJECTION_H_
+
+#include <initializer_list>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "json.h"
+
+namespace json {
+
+/*
+ * A set of JSON Pointers (RFC 6901) to extract from a document; a "*" token
+ * matches every key or index. parse() builds only the requested subtrees and
+ * skips everything else by balancing brackets and quotes, so the skipped
+ * parts are not validated. Once every path is resolved the parse stops
+ * without reading the rest; with check_rest the rest is skipped the same way,
+ * only to make sure the document is complete.
+ *
+ * Array elements keep their index: the ones skipped before a selected element
+ * become null.
+ */
+class Projection
+{
+public:
+    Projection();
+    Projection(std::initializer_list<char const*> const& pointers);
+
+    bool add(char const* pointer);
+    bool add(std::string const& pointer);
+    void clear();
+    bool empty() const;
+
+    bool parse(char const* first, char const* last, Value* result, ParseError* error = null, bool check_rest = false) const;
+    bool parse(std::string const& data, Value* result, ParseError* error = null, bool check_rest = false) const;
+
+private:
+    struct Node
+    {
+        std::vector<std::pair<std::string, Uint>> children;
+        Uint wildcard = 0;
+        bool terminal = false;
+    };
+
+    struct State;
+
+    Uint addChild(Uint node, std::string const& token);
+    void merge(Uint target, Uint source);
+    Uint findChild(Uint node, StringView key) const;
+    bool resolved(State& state, Uint node) const;
+
+    bool parseValue(State& state, Uint node, Value* result) const;
+    bool parseMap(State& state, Uint node, Value* result) const;
+    bool parseArray(State& state, Uint node, Value* result) const;
+
+private:
+    std::vector<Node> m_nodes;
+};
+
+}  // namespace json
+
+
+#endif /* _JSON_JSONPROJECTION_H_ */
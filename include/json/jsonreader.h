@@ -0,0 +1,392 @@
+/*
+ * jsonreader.h
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef _JSON_JSONREADER_H_
+#define _JSON_JSONREADER_H_
+
+#include <vector>
+
+#include "json.h"
+#include "jsonscanner.h"
+
+namespace json {
+
+/*
+ * Hands a raw number to a handler with onRawNumber(); Reader and StreamReader
+ * call it with 0 to prefer this overload.
+ */
+template<typename Handler>
+inline auto sendRawNumber(Handler& handler, StringView text, Number::Type type, int)
+    -> decltype(handler.onRawNumber(text, type))
+{
+    return handler.onRawNumber(text, type);
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*
+ * The handler has no onRawNumber(): convert the text after all.
+ */
+template<typename Handler>
+inline bool sendRawNumber(Handler& handler, StringView text, Number::Type, long)
+{
+    Number number;
+    Number::parse(text.data, text.data + text.length, &number);
+
+    if (number.type == Number::typeInteger)
+        return handler.onInteger(number.integer);
+    else
+        return handler.onDouble(number.real);
+}
+
+/*
+ * Event parser. Instead of building a Value it calls the handler for every
+ * token it meets, so the handler is a template parameter and the calls can
+ * be inlined. The handler must provide:
+ *
+ *     bool onNull();
+ *     bool onBool(bool value);
+ *     bool onInteger(Integer value);
+ *     bool onDouble(double value);
+ *     bool onString(StringView value);
+ *     bool onKey(StringView key);
+ *     bool onStartObject();
+ *     bool onEndObject();
+ *     bool onStartArray();
+ *     bool onEndArray();
+ *
+ * Views passed to onString() and onKey() are valid only during the call.
+ * Returning false from any of them stops the parse with errorAborted.
+ *
+ * After setRawNumbers(true) the numbers are checked but not converted and a
+ * handler that provides
+ *
+ *     bool onRawNumber(StringView text, Number::Type type);
+ *
+ * gets their text instead, with the type they would be converted to. Other
+ * handlers still get onInteger() and onDouble(), and so do 0x integers.
+ *
+ * Nesting is tracked on a heap stack rather than by recursion, so deep input
+ * costs no native stack; containers deeper than maxDepth() (JSON_MAX_DEPTH
+ * by default) stop the parse with errorDepthLimit.
+ *
+ * The grammar is StrictGrammar or RelaxedGrammar (see json.h).
+ */
+template<typename Handler, typename Grammar = RelaxedGrammar>
+class Reader
+{
+public:
+    explicit Reader(Handler& handler);
+
+    void setMaxDepth(Uint max_depth);
+    Uint maxDepth() const;
+
+    void setRawNumbers(bool raw_numbers);
+    bool rawNumbers() const;
+
+    bool parse(char const* first, char const* last, ParseError* error = null);
+    bool parseInSitu(char* first, char* last, ParseError* error = null);
+
+    /*
+     * Reads one value at the position of the scanner and leaves the scanner
+     * right after it, for parsers that hand parts of a document to a reader.
+     */
+    bool parseValue(Scanner& scanner);
+
+private:
+    bool parseDocument(Scanner& scanner, ParseError* error);
+    bool parseScalar(Scanner& scanner);
+    bool parseKey(Scanner& scanner);
+
+private:
+    Handler&            m_handler;
+    Uint                m_max_depth = JSON_MAX_DEPTH;
+    bool                m_raw_numbers = false;
+    std::vector<char>   m_stack;
+};
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Handler, typename Grammar>
+Reader<Handler, Grammar>::Reader(Handler& handler) :
+        m_handler(handler)
+{
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Handler, typename Grammar>
+void Reader<Handler, Grammar>::setMaxDepth(Uint max_depth)
+{
+    m_max_depth = max_depth;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Handler, typename Grammar>
+Uint Reader<Handler, Grammar>::maxDepth() const
+{
+    return m_max_depth;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Handler, typename Grammar>
+void Reader<Handler, Grammar>::setRawNumbers(bool raw_numbers)
+{
+    m_raw_numbers = raw_numbers;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Handler, typename Grammar>
+bool Reader<Handler, Grammar>::rawNumbers() const
+{
+    return m_raw_numbers;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Handler, typename Grammar>
+bool Reader<Handler, Grammar>::parse(char const* first, char const* last, ParseError* error)
+{
+    Scanner scanner(first, last);
+    return parseDocument(scanner, error);
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Handler, typename Grammar>
+bool Reader<Handler, Grammar>::parseInSitu(char* first, char* last, ParseError* error)
+{
+    Scanner scanner(first, last, true);
+    return parseDocument(scanner, error);
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Handler, typename Grammar>
+bool Reader<Handler, Grammar>::parseDocument(Scanner& scanner, ParseError* error)
+{
+    scanner.buildIndex<Grammar>();
+
+    if (parseValue(scanner))
+    {
+        if (not scanner.skipSpaces<Grammar>() and not scanner.failed())
+            return true;
+
+        scanner.setError(ParseError::errorUnexpectedSymbol);
+    }
+
+    if (error)
+        scanner.getError(error);
+
+    return false;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*
+ * m_stack holds the opening bracket of every open container. Each turn of
+ * the outer loop reads one value; the inner loop then consumes the commas
+ * and closing brackets that follow it, up to the start of the next value.
+ */
+template<typename Handler, typename Grammar>
+bool Reader<Handler, Grammar>::parseValue(Scanner& scanner)
+{
+    m_stack.clear();
+
+    while (true)
+    {
+        if (not scanner.skipSpaces<Grammar>())
+            return scanner.setError(ParseError::errorUnexpectedEnd);
+
+        char c = scanner.peek();
+
+        if (c == '{' or c == '[')
+        {
+            if (m_stack.size() >= m_max_depth)
+                return scanner.setError(ParseError::errorDepthLimit);
+
+            scanner.advance();
+            m_stack.push_back(c);
+
+            if (not (c == '{' ? m_handler.onStartObject() : m_handler.onStartArray()))
+                return scanner.setError(ParseError::errorAborted);
+
+            if (not scanner.skipSpaces<Grammar>())
+                return scanner.setError(ParseError::errorUnexpectedEnd);
+
+            if (scanner.peek() != (c == '{' ? '}' : ']'))
+            {
+                if (c == '{' and not parseKey(scanner))
+                    return false;
+
+                continue;
+            }
+        }
+        else if (not parseScalar(scanner))
+            return false;
+        else if (m_stack.empty())
+            return true;
+        else if (not scanner.skipSpaces<Grammar>())
+            return scanner.setError(ParseError::errorUnexpectedEnd);
+
+        while (true)
+        {
+            char kind = m_stack.back();
+            char close = (kind == '{' ? '}' : ']');
+
+            c = scanner.peek();
+
+            if (c == ',')
+            {
+                scanner.advance();
+
+                if (not scanner.skipSpaces<Grammar>())
+                    return scanner.setError(ParseError::errorUnexpectedEnd);
+
+                if (scanner.peek() != close)
+                {
+                    if (kind == '{' and not parseKey(scanner))
+                        return false;
+
+                    break;
+                }
+
+                if (not Grammar::allowTrailingCommas)
+                    return scanner.setError(kind == '{' ? ParseError::errorExpectedString : ParseError::errorUnexpectedSymbol);
+            }
+            else if (c != close)
+                return scanner.setError(ParseError::errorUnexpectedSymbol);
+
+            scanner.advance();
+            m_stack.pop_back();
+
+            if (not (kind == '{' ? m_handler.onEndObject() : m_handler.onEndArray()))
+                return scanner.setError(ParseError::errorAborted);
+
+            if (m_stack.empty())
+                return true;
+
+            if (not scanner.skipSpaces<Grammar>())
+                return scanner.setError(ParseError::errorUnexpectedEnd);
+        }
+    }
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Handler, typename Grammar>
+inline bool Reader<Handler, Grammar>::parseScalar(Scanner& scanner)
+{
+    switch (scanner.peek())
+    {
+        case '"':
+        {
+            StringView str;
+
+            if (not scanner.readString<Grammar>(&str))
+                return false;
+
+            return m_handler.onString(str) or scanner.setError(ParseError::errorAborted);
+        }
+
+        case 't':
+            if (not scanner.readLiteral("true", 4))
+                return false;
+
+            return m_handler.onBool(true) or scanner.setError(ParseError::errorAborted);
+
+        case 'f':
+            if (not scanner.readLiteral("false", 5))
+                return false;
+
+            return m_handler.onBool(false) or scanner.setError(ParseError::errorAborted);
+
+        case 'n':
+            if (not scanner.readLiteral("null", 4))
+                return false;
+
+            return m_handler.onNull() or scanner.setError(ParseError::errorAborted);
+
+        case '-':
+        case '0':
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+        case '6':
+        case '7':
+        case '8':
+        case '9':
+        {
+            Number number;
+
+            if (m_raw_numbers and not (Grammar::allowHexNumbers and scanner.startsWith("0x", 2)))
+            {
+                StringView text;
+
+                if (not scanner.readRawNumber(&text, &number.type))
+                    return false;
+
+                return sendRawNumber(m_handler, text, number.type, 0) or scanner.setError(ParseError::errorAborted);
+            }
+
+            if (not scanner.readNumber<Grammar>(&number))
+                return false;
+
+            if (number.type == Number::typeInteger)
+                return m_handler.onInteger(number.integer) or scanner.setError(ParseError::errorAborted);
+            else
+                return m_handler.onDouble(number.real) or scanner.setError(ParseError::errorAborted);
+        }
+
+        case '\0':
+            return scanner.setError(ParseError::errorUnexpectedNull);
+
+        default:
+            return scanner.setError(ParseError::errorUnexpectedSymbol);
+    }
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Handler, typename Grammar>
+inline bool Reader<Handler, Grammar>::parseKey(Scanner& scanner)
+{
+    StringView key;
+
+    if (not scanner.readString<Grammar>(&key))
+        return false;
+
+    if (not m_handler.onKey(key))
+        return scanner.setError(ParseError::errorAborted);
+
+    if (not scanner.skipSpaces<Grammar>())
+        return scanner.setError(ParseError::errorUnexpectedEnd);
+
+    if (scanner.peek() != ':')
+        return scanner.setError(ParseError::errorExpectedColon);
+
+    scanner.advance();
+
+    return true;
+}
+
+}  // namespace json
+
+
+#endif /* _JSON_JSONREADER_H_ */
@@ -0,0 +1,242 @@
+/*
+ * jsonscanner.h
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef _JSON_JSONSCANNER_H_
+#define _JSON_JSONSCANNER_H_
+
+#include "json.h"
+
+namespace json {
+
+/*
+ * Tokenizer shared by every parser: a bounded cursor over the input that
+ * skips spaces and comments and reads strings, numbers and literals. The
+ * first error it is told about sticks, together with its position.
+ *
+ * Strings without escapes are returned as views into the input. Escaped
+ * strings are decoded into an internal buffer, or over the input itself in
+ * the in-situ mode, so a view stays valid only until the next readString().
+ *
+ * The methods that depend on the grammar take it as a template argument and
+ * are instantiated for StrictGrammar and RelaxedGrammar.
+ */
+class Scanner
+{
+public:
+    Scanner(char const* first, char const* last, bool in_situ = false);
+    ~Scanner();
+
+    /*
+     * For inputs of 1 KiB and more: skipSpaces() then goes from one position
+     * of the structural index to the next instead of over the spaces. The
+     * grammar must be the one skipSpaces() is called with.
+     */
+    template<typename Grammar = RelaxedGrammar>
+    void buildIndex();
+
+    bool atEnd() const;
+    char peek() const;
+    void advance();
+    bool startsWith(char const* str, Uint length) const;
+
+    template<typename Grammar = RelaxedGrammar>
+    bool skipSpaces();
+
+    bool readLiteral(char const* literal, Uint length);
+
+    template<typename Grammar = RelaxedGrammar>
+    bool readString(StringView* result);
+
+    template<typename Grammar = RelaxedGrammar>
+    bool readNumber(Number* result);
+
+    /*
+     * Check a string or a number exactly as the read methods do but
+     * without decoding or converting it.
+     */
+    template<typename Grammar = RelaxedGrammar>
+    bool skipString();
+
+    template<typename Grammar = RelaxedGrammar>
+    bool skipNumber();
+
+    /*
+     * Checks a JSON number and returns its text with the type it converts
+     * to. 0x integers are left to readNumber().
+     */
+    bool readRawNumber(StringView* result, Number::Type* type);
+
+    bool setError(ParseError::Code code);
+    bool failed() const;
+    void getError(ParseError* error) const;
+
+    char const* first() const;
+    char const* last() const;
+    char const* current() const;
+    Uint offset() const;
+
+private:
+    Scanner(Scanner const&) = delete;
+    Scanner& operator=(Scanner const&) = delete;
+
+    char at(Uint ix) const;
+    bool skipComment();
+    void appendScratch(char const* str, Uint count);
+
+    template<typename Grammar>
+    void skipBlanks();
+
+    template<typename Grammar>
+    bool skipSpacesAndComments();
+
+    template<typename Grammar>
+    bool nextStructural();
+
+    template<typename Grammar>
+    int readEscape(char* result);
+
+    template<typename Grammar>
+    static bool isSpace(char c);
+
+    template<typename Grammar>
+    static char const* findStringSpecial(char const* first, char const* last, bool* non_ascii);
+
+    static int hexValue(char c);
+    static int encodeUtf8(unsigned code, char* result);
+
+private:
+    char const*         m_first = null;
+    char const*         m_last = null;
+    char const*         m_current = null;
+    Uint const*         m_structural = null;
+    char const*         m_error_position = null;
+    ParseError::Code    m_error = ParseError::errorNone;
+    bool                m_in_situ = false;
+    char*               m_scratch = null;
+    Uint                m_scratch_length = 0;
+    Uint                m_scratch_size = 0;
+    StructuralIndex     m_index;
+};
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+inline bool Scanner::atEnd() const
+{
+    return m_current >= m_last;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+inline char Scanner::peek() const
+{
+    return (m_current < m_last ? *m_current : 0);
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+inline void Scanner::advance()
+{
+    ++m_current;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Grammar>
+inline bool Scanner::skipSpaces()
+{
+    if (m_structural)
+        return nextStructural<Grammar>();
+
+    if (m_current < m_last and static_cast<unsigned char>(*m_current) > ' '
+        and (not Grammar::allowComments or *m_current != '/'))
+        return true;
+
+    return skipSpacesAndComments<Grammar>();
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*
+ * Moves to the next position of the structural index. The bytes before it are
+ * all spaces when the first of them is one; otherwise the last token ran into
+ * garbage, and skipSpacesAndComments() stops on it.
+ */
+template<typename Grammar>
+inline bool Scanner::nextStructural()
+{
+    Uint position = m_current - m_first;
+
+    while (*m_structural < position)
+        ++m_structural;
+
+    if (*m_structural != position and not isSpace<Grammar>(*m_current))
+        return skipSpacesAndComments<Grammar>();
+
+    m_current = m_first + *m_structural;
+
+    if (Grammar::allowComments and m_current < m_last and *m_current == '/')
+        return skipSpacesAndComments<Grammar>();
+
+    return m_current < m_last;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Grammar>
+inline bool Scanner::isSpace(char c)
+{
+    switch (c)
+    {
+        case '\n' :
+        case '\r' :
+        case ' ' :
+        case '\t' :
+            return true;
+        case '\v' :
+        case '\f' :
+        case '\b' :
+            return Grammar::allowExtraSpaces;
+        default:
+            return false;
+    }
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+inline bool Scanner::setError(ParseError::Code code)
+{
+    if (m_error == ParseError::errorNone)
+    {
+        m_error = code;
+        m_error_position = m_current;
+    }
+
+    return false;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+inline bool Scanner::failed() const
+{
+    return m_error != ParseError::errorNone;
+}
+
+}  // namespace json
+
+
+#endif /* _JSON_JSONSCANNER_H_ */
@@ -0,0 +1,613 @@
+/*
+ * jsonstream.h
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef _JSON_JSONSTREAM_H_
+#define _JSON_JSONSTREAM_H_
+
+#include <string.h>
+#include <vector>
+
+#include "json.h"
+#include "jsonreader.h"
+#include "jsonscanner.h"
+
+namespace json {
+
+/*
+ * Push parser: the document is fed in chunks of any size as they arrive and
+ * the handler (see Reader) is called as soon as a token is complete. Only
+ * the nesting of the open containers and the one token that straddles two
+ * chunks are kept between the calls. The grammar, the depth limit and the
+ * raw numbers work as in Reader.
+ */
+template<typename Handler, typename Grammar = RelaxedGrammar>
+class StreamReader
+{
+public:
+    explicit StreamReader(Handler& handler);
+
+    void setMaxDepth(Uint max_depth);
+    Uint maxDepth() const;
+
+    void setRawNumbers(bool raw_numbers);
+    bool rawNumbers() const;
+
+    bool feed(char const* data, Uint length);
+    bool finish(ParseError* error = null);
+    void reset();
+
+    bool done() const;
+    bool failed() const;
+    void getError(ParseError* error) const;
+
+private:
+    enum State
+    {
+        stateValue,
+        stateValueOrEnd,
+        stateKey,
+        stateKeyOrEnd,
+        stateColon,
+        stateCommaOrEnd,
+        stateDone
+    };
+
+    enum Token
+    {
+        tokenNone,
+        tokenString,
+        tokenScalar
+    };
+
+    enum Comment
+    {
+        commentNone,
+        commentSlash,
+        commentLine,
+        commentBlock,
+        commentBlockStar
+    };
+
+    char const* readToken(char const* first, char const* last);
+    char const* readComment(char const* first, char const* last);
+    bool startContainer(char kind);
+    bool endContainer(char kind);
+    bool processToken(char const* first, char const* last, size_t offset);
+    void valueDone();
+    bool setError(ParseError::Code code, size_t offset);
+
+    static bool isSpace(char c);
+    static bool isScalarChar(char c);
+
+private:
+    Handler&            m_handler;
+    Uint                m_max_depth = JSON_MAX_DEPTH;
+    bool                m_raw_numbers = false;
+    State               m_state = stateValue;
+    Token               m_token = tokenNone;
+    Comment             m_comment = commentNone;
+    bool                m_escape = false;
+    bool                m_comment_escape = false;
+    char const*         m_token_first = null;
+    size_t              m_token_offset = 0;
+    size_t              m_offset = 0;
+    ParseError::Code    m_error = ParseError::errorNone;
+    size_t              m_error_offset = 0;
+    std::vector<char>   m_pending;
+    std::vector<char>   m_stack;
+};
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Handler, typename Grammar>
+StreamReader<Handler, Grammar>::StreamReader(Handler& handler) :
+        m_handler(handler)
+{
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Handler, typename Grammar>
+void StreamReader<Handler, Grammar>::setMaxDepth(Uint max_depth)
+{
+    m_max_depth = max_depth;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Handler, typename Grammar>
+Uint StreamReader<Handler, Grammar>::maxDepth() const
+{
+    return m_max_depth;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Handler, typename Grammar>
+void StreamReader<Handler, Grammar>::setRawNumbers(bool raw_numbers)
+{
+    m_raw_numbers = raw_numbers;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Handler, typename Grammar>
+bool StreamReader<Handler, Grammar>::rawNumbers() const
+{
+    return m_raw_numbers;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Handler, typename Grammar>
+bool StreamReader<Handler, Grammar>::feed(char const* data, Uint length)
+{
+    char const* p = data;
+    char const* last = data + length;
+
+    size_t chunk_offset = m_offset;
+    m_offset += length;
+
+    if (failed())
+        return false;
+
+    if (m_token != tokenNone)
+        p = readToken(p, last);
+
+    while (p < last and not failed())
+    {
+        if (m_comment != commentNone)
+        {
+            p = readComment(p, last);
+            continue;
+        }
+
+        char c = *p;
+        size_t offset = chunk_offset + (p - data);
+
+        if (isSpace(c))
+        {
+            ++p;
+            continue;
+        }
+
+        if (Grammar::allowComments and c == '/')
+        {
+            m_comment = commentSlash;
+            m_token_offset = offset;
+            ++p;
+            continue;
+        }
+        else if ((m_state == stateKeyOrEnd and c != '"' and c != '}') or (m_state == stateKey and c != '"'))
+            return setError(ParseError::errorExpectedString, offset);
+        else if (m_state == stateColon and c != ':')
+            return setError(ParseError::errorExpectedColon, offset);
+
+        switch (c)
+        {
+            case '{':
+            case '[':
+                if (m_state != stateValue and m_state != stateValueOrEnd)
+                    return setError(ParseError::errorUnexpectedSymbol, offset);
+
+                if (m_stack.size() >= m_max_depth)
+                    return setError(ParseError::errorDepthLimit, offset);
+
+                if (not startContainer(c))
+                    return setError(ParseError::errorAborted, offset + 1);
+
+                ++p;
+                continue;
+
+            case '}':
+            case ']':
+                if (m_stack.empty() or m_stack.back() != (c == '}' ? '{' : '[')
+                    or (m_state != stateCommaOrEnd and m_state != stateValueOrEnd and m_state != stateKeyOrEnd))
+                    return setError(ParseError::errorUnexpectedSymbol, offset);
+
+                if (not endContainer(c))
+                    return setError(ParseError::errorAborted, offset + 1);
+
+                ++p;
+                continue;
+
+            case ',':
+                if (m_state != stateCommaOrEnd)
+                    return setError(ParseError::errorUnexpectedSymbol, offset);
+
+                if (Grammar::allowTrailingCommas)
+                    m_state = (m_stack.back() == '[' ? stateValueOrEnd : stateKeyOrEnd);
+                else
+                    m_state = (m_stack.back() == '[' ? stateValue : stateKey);
+
+                ++p;
+                continue;
+
+            case ':':
+                if (m_state != stateColon)
+                    return setError(ParseError::errorUnexpectedSymbol, offset);
+
+                m_state = stateValue;
+                ++p;
+                continue;
+
+            case '"':
+                if (m_state == stateCommaOrEnd or m_state == stateDone)
+                    return setError(ParseError::errorUnexpectedSymbol, offset);
+
+                m_token = tokenString;
+                break;
+
+            default:
+                if (m_state == stateCommaOrEnd or m_state == stateDone)
+                    return setError(ParseError::errorUnexpectedSymbol, offset);
+                else if (c == '\0')
+                    return setError(ParseError::errorUnexpectedNull, offset);
+                else if (not isScalarChar(c))
+                    return setError(ParseError::errorUnexpectedSymbol, offset);
+
+                m_token = tokenScalar;
+                break;
+        }
+
+        m_token_first = p;
+        m_token_offset = offset;
+        m_escape = false;
+        m_pending.clear();
+
+        p = readToken(p + (m_token == tokenString ? 1 : 0), last);
+    }
+
+    return not failed();
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Handler, typename Grammar>
+bool StreamReader<Handler, Grammar>::finish(ParseError* error)
+{
+    if (not failed())
+    {
+        if (m_token != tokenNone)
+        {
+            m_token = tokenNone;
+            processToken(m_pending.data(), m_pending.data() + m_pending.size(), m_token_offset);
+        }
+
+        if (m_comment == commentSlash)
+            setError(ParseError::errorUnexpectedSymbol, m_token_offset);
+        else if (m_comment == commentBlock or m_comment == commentBlockStar)
+            setError(ParseError::errorUnterminatedComment, m_offset);
+
+        if (m_state != stateDone)
+            setError(ParseError::errorUnexpectedEnd, m_offset);
+    }
+
+    if (error)
+        getError(error);
+
+    return not failed();
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Handler, typename Grammar>
+void StreamReader<Handler, Grammar>::reset()
+{
+    m_state = stateValue;
+    m_token = tokenNone;
+    m_comment = commentNone;
+    m_escape = false;
+    m_comment_escape = false;
+    m_offset = 0;
+    m_error = ParseError::errorNone;
+    m_error_offset = 0;
+    m_pending.clear();
+    m_stack.clear();
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Handler, typename Grammar>
+bool StreamReader<Handler, Grammar>::done() const
+{
+    return m_state == stateDone and m_token == tokenNone and not failed();
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Handler, typename Grammar>
+bool StreamReader<Handler, Grammar>::failed() const
+{
+    return m_error != ParseError::errorNone;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Handler, typename Grammar>
+void StreamReader<Handler, Grammar>::getError(ParseError* error) const
+{
+    error->code = m_error;
+    error->offset = m_error_offset;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*
+ * Looks for the end of the current token. If the chunk ends first, the part
+ * seen so far is kept in m_pending; otherwise the token is processed in place
+ * when it lies in one chunk.
+ */
+template<typename Handler, typename Grammar>
+char const* StreamReader<Handler, Grammar>::readToken(char const* first, char const* last)
+{
+    char const* p = first;
+    char const* end = null;
+
+    if (m_token == tokenString)
+    {
+        if (m_escape and p < last)
+        {
+            m_escape = false;
+            ++p;
+        }
+
+        while (p < last)
+        {
+            char const* quote = static_cast<char const*>(::memchr(p, '"', last - p));
+            char const* run = quote ? quote : last;
+            char const* back = run;
+
+            while (back > p and back[-1] == '\\')
+                --back;
+
+            if (quote == null)
+            {
+                m_escape = ((run - back) & 1) != 0;
+                break;
+            }
+            else if (((run - back) & 1) == 0)
+            {
+                end = quote + 1;
+                break;
+            }
+
+            p = quote + 1;
+        }
+    }
+    else
+    {
+        while (p < last and isScalarChar(*p))
+            ++p;
+
+        if (p < last)
+            end = p;
+    }
+
+    if (end == null)
+    {
+        if (m_pending.empty())
+            m_pending.insert(m_pending.end(), m_token_first, last);
+        else
+            m_pending.insert(m_pending.end(), first, last);
+
+        return last;
+    }
+
+    m_token = tokenNone;
+
+    if (m_pending.empty())
+        processToken(m_token_first, end, m_token_offset);
+    else
+    {
+        m_pending.insert(m_pending.end(), first, end);
+        processToken(m_pending.data(), m_pending.data() + m_pending.size(), m_token_offset);
+    }
+
+    return end;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Handler, typename Grammar>
+char const* StreamReader<Handler, Grammar>::readComment(char const* first, char const* last)
+{
+    char const* p = first;
+
+    while (p < last and m_comment != commentNone)
+    {
+        char c = *p++;
+
+        if (m_comment == commentSlash)
+        {
+            if (c == '/')
+                m_comment = commentLine;
+            else if (c == '*')
+                m_comment = commentBlock;
+            else
+                setError(ParseError::errorUnexpectedSymbol, m_token_offset);
+
+            m_comment_escape = false;
+        }
+        else if (m_comment_escape)
+            m_comment_escape = false;
+        else if (c == '\\')
+        {
+            m_comment_escape = true;
+
+            if (m_comment == commentBlockStar)
+                m_comment = commentBlock;
+        }
+        else if (m_comment == commentLine)
+        {
+            if (c == '\n')
+                m_comment = commentNone;
+        }
+        else if (m_comment == commentBlockStar and c == '/')
+            m_comment = commentNone;
+        else
+            m_comment = (c == '*' ? commentBlockStar : commentBlock);
+    }
+
+    return (failed() ? last : p);
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Handler, typename Grammar>
+bool StreamReader<Handler, Grammar>::startContainer(char kind)
+{
+    m_stack.push_back(kind);
+
+    if (kind == '{')
+    {
+        m_state = stateKeyOrEnd;
+        return m_handler.onStartObject();
+    }
+
+    m_state = stateValueOrEnd;
+    return m_handler.onStartArray();
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Handler, typename Grammar>
+bool StreamReader<Handler, Grammar>::endContainer(char kind)
+{
+    m_stack.pop_back();
+    valueDone();
+
+    return (kind == '}' ? m_handler.onEndObject() : m_handler.onEndArray());
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Handler, typename Grammar>
+bool StreamReader<Handler, Grammar>::processToken(char const* first, char const* last, size_t offset)
+{
+    Scanner scanner(first, last);
+    StringView str;
+    Number number;
+    bool handled = true;
+
+    switch (*first)
+    {
+        case '"':
+            if (not scanner.readString<Grammar>(&str))
+                break;
+
+            if (m_state == stateKeyOrEnd or m_state == stateKey)
+            {
+                m_state = stateColon;
+                handled = m_handler.onKey(str);
+            }
+            else
+            {
+                valueDone();
+                handled = m_handler.onString(str);
+            }
+            break;
+
+        case 't':
+        case 'f':
+            if (not scanner.readLiteral(*first == 't' ? "true" : "false", *first == 't' ? 4 : 5))
+                break;
+
+            valueDone();
+            handled = m_handler.onBool(*first == 't');
+            break;
+
+        case 'n':
+            if (not scanner.readLiteral("null", 4))
+                break;
+
+            valueDone();
+            handled = m_handler.onNull();
+            break;
+
+        default:
+            if (*first != '-' and (*first < '0' or *first > '9'))
+                scanner.setError(ParseError::errorUnexpectedSymbol);
+            else if (m_raw_numbers and not (Grammar::allowHexNumbers and scanner.startsWith("0x", 2)))
+            {
+                if (scanner.readRawNumber(&str, &number.type))
+                {
+                    valueDone();
+                    handled = sendRawNumber(m_handler, str, number.type, 0);
+                }
+            }
+            else if (scanner.readNumber<Grammar>(&number))
+            {
+                valueDone();
+
+                if (number.type == Number::typeInteger)
+                    handled = m_handler.onInteger(number.integer);
+                else
+                    handled = m_handler.onDouble(number.real);
+            }
+            break;
+    }
+
+    if (not handled)
+        scanner.setError(ParseError::errorAborted);
+    else if (not scanner.atEnd())
+        scanner.setError(ParseError::errorUnexpectedSymbol);
+
+    if (scanner.failed())
+    {
+        ParseError error;
+        scanner.getError(&error);
+        return setError(error.code, offset + error.offset);
+    }
+
+    return true;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Handler, typename Grammar>
+void StreamReader<Handler, Grammar>::valueDone()
+{
+    m_state = (m_stack.empty() ? stateDone : stateCommaOrEnd);
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Handler, typename Grammar>
+bool StreamReader<Handler, Grammar>::setError(ParseError::Code code, size_t offset)
+{
+    if (m_error == ParseError::errorNone)
+    {
+        m_error = code;
+        m_error_offset = offset;
+    }
+
+    return false;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Handler, typename Grammar>
+inline bool StreamReader<Handler, Grammar>::isSpace(char c)
+{
+    if (c == ' ' or c == '\t' or c == '\n' or c == '\r')
+        return true;
+
+    return Grammar::allowExtraSpaces and c >= '\b' and c <= '\r';
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Handler, typename Grammar>
+inline bool StreamReader<Handler, Grammar>::isScalarChar(char c)
+{
+    return ((c | 0x20) >= 'a' and (c | 0x20) <= 'z') or (c >= '0' and c <= '9') or c == '.' or c == '+' or c == '-';
+}
+
+}  // namespace json
+
+
+#endif /* _JSON_JSONSTREAM_H_ */
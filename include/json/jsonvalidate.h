@@ -0,0 +1,49 @@
+/*
+ * jsonvalidate.h
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef _JSON_JSONVALIDATE_H_
+#define _JSON_JSONVALIDATE_H_
+
+#include "json.h"
+
+namespace json {
+
+/*
+ * Checks that the data is one well-formed document: the grammar, UTF-8 in
+ * the strings and the nesting depth up to max_depth, which works as
+ * Reader::setMaxDepth(). It reports the same errors at the same offsets as
+ * the parsers, but nothing is decoded, converted or copied, and nothing is
+ * allocated unless max_depth is above JSON_MAX_DEPTH. Instantiated for
+ * StrictGrammar and RelaxedGrammar.
+ */
+template<typename Grammar = RelaxedGrammar>
+bool validate(char const* first, char const* last, ParseError* error = null, Uint max_depth = JSON_MAX_DEPTH);
+
+}  // namespace json
+
+
+#endif /* _JSON_JSONVALIDATE_H_ */
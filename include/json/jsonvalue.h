@@ -46,10 +46,16 @@ constexpr size_t static_max()
     return static_max<sizeof(vT) < pS ? pS : sizeof(vT), Args...>();
 }
 
+/*
+ * 16 bytes: an 8-byte payload, the length of a text, the type and flags. The
+ * payload is a scalar, a pointer to the text of a string or a pointer to a
+ * container kept out of line, so arrays and map slots of scalars stay dense.
+ * Texts of up to 8 bytes are stored in the payload itself.
+ */
 struct Value
 {
 public:
-    enum Type
+    enum Type : unsigned char
     {
         untyped,
         typeNull,
@@ -62,14 +68,30 @@ public:
     };
 
 private:
-    enum {
-        holder_size = static_max<0, bool, Integer, double, std::string, ArrayBase, MapBase>()
+    enum
+    {
+        holder_size = static_max<0, bool, Integer, double, char*, Array*, Map*>()
     };
 
-    using HolderType = typename std::aligned_storage<holder_size>::type;
+    using HolderType = typename std::aligned_storage<holder_size, holder_size>::type;
 
-    Type        m_type = Type::untyped;
-    HolderType  m_data = {};
+    /*
+     * A raw number is one parsed with raw_numbers: its text, converted on
+     * every read and written back as it is. Borrowed texts live in the parsed
+     * buffer or in an arena, external containers in an arena; neither is
+     * freed.
+     */
+    enum Flags
+    {
+        flagRawNumber = 1 << 0,
+        flagBorrowed = 1 << 1,
+        flagExternal = 1 << 2
+    };
+
+    HolderType      m_data = {};
+    Uint            m_length = 0;
+    Type            m_type = Type::untyped;
+    unsigned char   m_flags = 0;
 
 public:
     using iterator = Value*;
@@ -113,6 +135,7 @@ public:
 
     bool hasKey(char const* key) const;
     bool hasKey(std::string const& key) const;
+    bool hasKey(Key const& key) const;
 
     operator bool() const;
     operator int() const;
@@ -150,10 +173,12 @@ public:
 
     Value& operator[](char const* key);
     Value& operator[](std::string const& key);
+    Value& operator[](Key const& key);
     Value& operator[](int ix);
 
     Value const& operator[](char const* key) const;
     Value const& operator[](std::string const& key) const;
+    Value const& operator[](Key const& key) const;
     Value const& operator[](int ix) const;
 
     char const* getKey(const_iterator iter) const;
@@ -170,11 +195,39 @@ public:
     static Uint distance(const_iterator first, const_iterator last);
     static Uint distance(iterator first, iterator last);
 
-    bool parseStream(FILE* fd);
-    bool parseFile(const char* filename);
-    bool parseFile(std::string const& filename);
-    bool parseData(char const* first, char const* last);
-    bool parseString(std::string const& data);
+    bool parseStream(FILE* fd, ParseError* error = null);
+    bool parseFile(const char* filename, ParseError* error = null);
+    bool parseFile(std::string const& filename, ParseError* error = null);
+
+    /*
+     * With raw_numbers the numbers keep their text: type() still tells an
+     * integer from a double, but the conversion is done by the accessors and
+     * saving writes the text back unchanged.
+     */
+    bool parseData(char const* first, char const* last, ParseError* error = null, bool raw_numbers = false);
+    bool parseString(std::string const& data, ParseError* error = null, bool raw_numbers = false);
+
+    /*
+     * Parses the buffer destructively: escapes are decoded in place and
+     * strings and keys point into it, so it must outlive the value.
+     */
+    bool parseDataInSitu(char* first, char* last, ParseError* error = null, bool raw_numbers = false);
+
+    /*
+     * The same with the grammar chosen at compile time, for example
+     * parseData<StrictGrammar>(); the plain versions are RelaxedGrammar.
+     */
+    template<typename Grammar>
+    bool parseData(char const* first, char const* last, ParseError* error = null, bool raw_numbers = false);
+
+    template<typename Grammar>
+    bool parseDataInSitu(char* first, char* last, ParseError* error = null, bool raw_numbers = false);
+
+    /*
+     * Parses the members of a large top-level array or object on several
+     * threads; anything else, or input with comments, is parsed as usual.
+     */
+    bool parseDataParallel(char const* first, char const* last, ParseError* error = null, Uint num_threads = 0);
 
     bool saveToStream(FILE* fd, bool pretty_print = false) const;
     bool saveToFile(char const* filename, bool pretty_print = false) const;
@@ -183,41 +236,18 @@ public:
     char* saveToData(int& length, bool pretty_print = false) const;
 
 private:
-    struct StateIterator
-    {
-        StateIterator();
-        StateIterator(char const* first_, char const* last_, char const* cur = null);
-        StateIterator(StateIterator const& other);
-        ~StateIterator();
-
-        StateIterator& operator=(char const* other);
-        StateIterator& operator+=(int nth);
-        void appendReason(char const* msg);
-        operator bool() const;
-        bool operator!() const;
-        char operator*() const;
-        StateIterator& operator++();
-        void increase(int count);
-        char operator[](int ix);
-        int index() const;
-
-        void assign(StateIterator const& other);
-
-    private:
-        int ref();
-        int unref();
-        void init();
-
-    public:
-        char const* first = null;
-        char const* last = null;
-        char const* current = null;
-        char** reasons = null;
-        Uint num_reasons = 0;
-
-    private:
-        int* rf = null;
-    };
+    struct Builder;
+    friend struct BindingBase;
+    friend class Document;
+
+    /*
+     * A container value whose object and buffers are allocated in the arena,
+     * which must outlive it.
+     */
+    Value(Type tp, Arena* arena);
+
+    template<typename Grammar>
+    bool parseInternal(char const* first, char const* last, bool in_situ, Arena* arena, bool intern_strings, KeyPool* keys, ParseError* error, bool raw_numbers);
 
 private:
     template<typename rT>
@@ -228,28 +258,34 @@ private:
     rT const& as() const
     {   return *reinterpret_cast<rT const*>(&m_data); }
 
+    Array& array()
+    {   return *as<Array*>(); }
+
+    Array const& array() const
+    {   return *as<Array*>(); }
+
+    Map& map()
+    {   return *as<Map*>(); }
+
+    Map const& map() const
+    {   return *as<Map*>(); }
+
     template<typename vT, typename ...Args>
-    void construct(Args&&... args)
-    {   ::new(reinterpret_cast<vT*>(&m_data)) vT(std::forward<Args>(args)...); }
+    void constructOutOfLine(Arena* arena, Args&&... args);
 
     template<typename vT>
-    void destruct()
-    {   reinterpret_cast<vT*>(&m_data)->~vT(); }
+    void destructOutOfLine();
 
-private:
-    static char* appendData(char* data, Uint& length, char const* block, Uint count);
-    static bool skipCommentsAndSpaces(StateIterator& iter);
-    static bool skipMultilineComment(StateIterator& iter);
-    static bool skipSinglelineComment(StateIterator& iter);
-    static bool parseString(StateIterator& iter, std::string& result);
-    static bool strIsDouble(StateIterator iter);
+    char const* text() const;
+    bool ownsText() const;
+    void setText(char const* str, Uint length, bool borrowed);
+
+    Number rawNumber() const;
 
 private:
-    bool parseArray(StateIterator& iter);
-    bool parseMap(StateIterator& iter);
-    bool parseValue(StateIterator& iter);
+    static void appendEscaped(std::string* result, char const* str, Uint length);
 
-    void dumpStringAsRaw(std::string* result) const;
+private:
     void dumpArray(std::string* result, bool pretty_print, bool as_raw, int indent) const;
     void dumpMap(std::string* result, bool pretty_print, bool as_raw, int indent) const;
     bool dumpInternal(std::string* result, bool pretty_print, bool as_raw, int indent) const;
@@ -0,0 +1,245 @@
+/*
+ * jsonarena.cpp
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "json/jsonarena.h"
+
+#include <memory.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <cassert>
+
+#if defined(__linux__)
+#  include <sys/mman.h>
+#  define JSON_ARENA_MMAP 1
+#endif
+
+namespace json {
+
+#define HUGE_PAGE_SIZE      (2 * 1024 * 1024)
+#define MAX_BLOCK_SIZE      (64 * 1024 * 1024)
+#define BLOCK_HEADER_SIZE   ((sizeof(Block) + alignment - 1) & ~size_t(alignment - 1))
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+struct Arena::Block
+{
+    Block*  next;
+    size_t  size;
+    bool    mapped;
+};
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+Arena::Arena(size_t block_size, bool huge_pages) :
+        m_block_size(std::max(block_size, size_t(1024))),
+        m_next_block_size(m_block_size),
+        m_huge_pages(huge_pages)
+{
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+Arena::Arena(void* buffer, size_t size) :
+        m_block_size(JSON_ARENA_BLOCK_SIZE),
+        m_next_block_size(m_block_size)
+{
+    uintptr_t first = reinterpret_cast<uintptr_t>(buffer);
+    uintptr_t aligned = (first + alignment - 1) & ~uintptr_t(alignment - 1);
+
+    if (buffer != null and aligned - first < size)
+    {
+        m_buffer = reinterpret_cast<char*>(aligned);
+        m_buffer_size = size - (aligned - first);
+    }
+
+    m_start = m_current = m_buffer;
+    m_end = m_buffer + m_buffer_size;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+Arena::~Arena()
+{
+    while (m_blocks)
+    {
+        Block* next = m_blocks->next;
+        freeBlock(m_blocks);
+        m_blocks = next;
+    }
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+char* Arena::copyString(char const* str, Uint length)
+{
+    char* result = static_cast<char*>(allocate(length + 1));
+
+    ::memcpy(result, str, length);
+    result[length] = '\0';
+
+    return result;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void Arena::release()
+{
+    Block* kept = (m_buffer ? null : m_blocks);
+    Block* block = (kept ? kept->next : m_blocks);
+
+    while (block)
+    {
+        Block* next = block->next;
+        freeBlock(block);
+        block = next;
+    }
+
+    m_blocks = kept;
+    m_used = 0;
+
+    if (kept)
+    {
+        kept->next = null;
+        m_start = reinterpret_cast<char*>(kept) + BLOCK_HEADER_SIZE;
+        m_end = reinterpret_cast<char*>(kept) + kept->size;
+    }
+    else
+    {
+        m_start = m_buffer;
+        m_end = m_buffer + m_buffer_size;
+    }
+
+    m_current = m_start;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+size_t Arena::used() const
+{
+    return m_used + (m_current - m_start);
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void* Arena::relocate(Arena* arena, void const* block, size_t used, size_t new_size)
+{
+    void* result = (arena ? arena->allocate(new_size) : ::malloc(new_size));
+
+    assert(result != null);
+
+    if (used)
+        ::memcpy(result, block, used);
+
+    return result;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*
+ * Requests larger than a quarter of a block get a block of their own behind
+ * the current one, so the rest of the current one is not wasted.
+ */
+void* Arena::allocateSlow(size_t size)
+{
+    if (size > m_next_block_size / 4 and m_blocks != null)
+    {
+        Block* block = newBlock(BLOCK_HEADER_SIZE + size);
+
+        block->next = m_blocks->next;
+        m_blocks->next = block;
+        m_used += size;
+
+        return reinterpret_cast<char*>(block) + BLOCK_HEADER_SIZE;
+    }
+
+    Block* block = newBlock(std::max(m_next_block_size, BLOCK_HEADER_SIZE + size));
+
+    block->next = m_blocks;
+    m_blocks = block;
+    m_next_block_size = std::min(m_next_block_size * 2, size_t(MAX_BLOCK_SIZE));
+
+    m_used += m_current - m_start;
+    m_start = reinterpret_cast<char*>(block) + BLOCK_HEADER_SIZE;
+    m_current = m_start + size;
+    m_end = reinterpret_cast<char*>(block) + block->size;
+
+    return m_start;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+Arena::Block* Arena::newBlock(size_t size)
+{
+    void* mem = null;
+    bool mapped = false;
+
+#ifdef JSON_ARENA_MMAP
+    if (m_huge_pages)
+    {
+        size = (size + HUGE_PAGE_SIZE - 1) & ~size_t(HUGE_PAGE_SIZE - 1);
+#  ifdef MAP_HUGETLB
+        mem = ::mmap(null, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#  else
+        mem = MAP_FAILED;
+#  endif
+
+        // No reserved huge pages: ask for transparent ones instead
+        if (mem == MAP_FAILED)
+        {
+            mem = ::mmap(null, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+#  ifdef MADV_HUGEPAGE
+            if (mem != MAP_FAILED)
+                ::madvise(mem, size, MADV_HUGEPAGE);
+#  endif
+        }
+
+        mapped = (mem != MAP_FAILED);
+
+        if (not mapped)
+            mem = null;
+    }
+#endif
+
+    if (mem == null)
+        mem = ::malloc(size);
+
+    assert(mem != null);
+
+    Block* block = static_cast<Block*>(mem);
+
+    block->next = null;
+    block->size = size;
+    block->mapped = mapped;
+
+    return block;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void Arena::freeBlock(Block* block)
+{
+#ifdef JSON_ARENA_MMAP
+    if (block->mapped)
+    {
+        ::munmap(block, block->size);
+        return;
+    }
+#endif
+
+    ::free(block);
+}
+
+}  // namespace json
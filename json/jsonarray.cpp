@@ -25,17 +25,19 @@
  */
 
 #include "json/jsonarray.h"
+#include "json/jsonarena.h"
 
 #include <memory.h>
+#include <algorithm>
 #include <cassert>
 #include <memory>
 
 namespace json {
 
 
-Array::Array(Uint initial_size)
+Array::Array(Uint initial_size, Arena* arena)
 {
-    reserve(initial_size);
+    reserve(initial_size, arena);
 }
 
 
@@ -67,7 +69,7 @@ Array::~Array()
 {
     std::_Destroy(begin(), end());
 
-    if (m_data)
+    if (m_data and not m_external)
         ::free(m_data);
 
     m_data = null;
@@ -110,12 +112,17 @@ void Array::swap(Array& other)
     std::swap(m_data, other.m_data);
     std::swap(m_num_items, other.m_num_items);
     std::swap(m_allocated_size, other.m_allocated_size);
+    std::swap(m_external, other.m_external);
 }
 
 
 void Array::clear()
 {
     std::_Destroy(begin(), end());
+
+    if (m_data)
+        ::memset(static_cast<void*>(m_data), 0, sizeof(Value) * numItems());
+
     m_num_items = 0;
 }
 
@@ -138,7 +145,7 @@ Value* Array::data() const
 }
 
 
-void Array::reserve(Uint new_size)
+void Array::reserve(Uint new_size, Arena* arena)
 {
     if (new_size == reserved() and m_data != null)
         return;
@@ -151,14 +158,25 @@ void Array::reserve(Uint new_size)
         num_elements = new_size;
     }
 
-    void* mem = ::realloc(m_data, sizeof(Value) * (new_size + 1));
+    void* mem;
+
+    if (arena or m_external)
+    {
+        mem = Arena::relocate(arena, m_data, sizeof(Value) * num_elements, sizeof(Value) * (new_size + 1));
+
+        if (m_data and not m_external)
+            ::free(m_data);
+
+        m_external = (arena != null);
+    }
+    else
+        mem = ::realloc(static_cast<void*>(m_data), sizeof(Value) * (new_size + 1));
 
     assert(mem != null);
 
     m_data = static_cast<Value*>(mem);
 
-    if (new_size > numItems())
-        ::memset(m_data + numItems(), 0, sizeof(Value) * (new_size - numItems()));
+    ::memset(static_cast<void*>(m_data + num_elements), 0, sizeof(Value) * (new_size + 1 - num_elements));
 
     m_allocated_size = new_size;
     m_num_items = num_elements;
@@ -172,6 +190,8 @@ void Array::resize(Uint new_size)
     if (new_size < numItems())
     {
         std::_Destroy(m_data + new_size, m_data + numItems());
+        ::memset(static_cast<void*>(m_data + new_size), 0, sizeof(Value) * (numItems() - new_size));
+        m_num_items = new_size;
 
         if (new_alloc < reserved())
             reserve(new_alloc);
@@ -199,8 +219,8 @@ void Array::insert(Uint position, json::const_iterator first, json::const_iterat
     resize(new_size);
     Value* current = data() + index;
 
-    ::memmove(current + num_elements, current, sizeof(Value) * (old_size - index));
-    ::memset(current, 0, sizeof(Value) * num_elements);
+    ::memmove(static_cast<void*>(current + num_elements), current, sizeof(Value) * (old_size - index));
+    ::memset(static_cast<void*>(current), 0, sizeof(Value) * num_elements);
 
     while (first < last)
     {
@@ -221,6 +241,15 @@ void Array::append(Value const& value)
 }
 
 
+void Array::append(Value&& value)
+{
+    if (numItems() == reserved())
+        reserve((reserved() * 3) / 2 + 1);
+
+    m_data[m_num_items++].swap(value);
+}
+
+
 void Array::append(json::const_iterator first, json::const_iterator last)
 {
     insert(numItems(), first, last);
@@ -247,7 +276,8 @@ void Array::remove(Uint index)
     Value* value = data() + index;
 
     value->~Value();
-    ::memmove(value, value + 1, sizeof(Value) * (numItems() - 1 - index));
+    ::memmove(static_cast<void*>(value), value + 1, sizeof(Value) * (numItems() - 1 - index));
+    ::memset(static_cast<void*>(data() + numItems() - 1), 0, sizeof(Value));
     resize(numItems() - 1);
 }
 
@@ -258,7 +288,7 @@ Value& Array::operator[](Uint index)
         return m_data[index];
 
     if (index >= reserved())
-        reserve(index + 1);
+        reserve(std::max(index + 1, (reserved() * 3) / 2 + 1));
 
     if (index >= numItems())
         m_num_items = index + 1;
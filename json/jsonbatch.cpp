@@ -0,0 +1,401 @@
+/*
+ * jsonbatch.cpp
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "json/jsonbatch.h"
+
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+
+namespace json {
+
+namespace {
+
+inline bool isSpace(char c)
+{
+    return c == ' ' or (c >= '\b' and c <= '\r');
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+char const* skipString(char const* first, char const* last)
+{
+    char const* p = first;
+
+    while (p < last)
+    {
+        char const* quote = static_cast<char const*>(::memchr(p, '"', last - p));
+
+        if (quote == null)
+            return last;
+
+        char const* back = quote;
+
+        while (back > p and back[-1] == '\\')
+            --back;
+
+        p = quote + 1;
+
+        if (((quote - back) & 1) == 0)
+            break;
+    }
+
+    return p;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+char const* skipComment(char const* first, char const* last)
+{
+    if (first[1] == '/')
+    {
+        char const* eol = static_cast<char const*>(::memchr(first + 2, '\n', last - first - 2));
+        return (eol ? eol + 1 : last);
+    }
+
+    for (char const* p = first + 2; p + 1 < last; ++p)
+    {
+        if (p[0] == '*' and p[1] == '/')
+            return p + 2;
+    }
+
+    return last;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+inline bool isComment(char const* p, char const* last)
+{
+    return p[0] == '/' and p + 1 < last and (p[1] == '/' or p[1] == '*');
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+char const* skipSeparators(char const* first, char const* last)
+{
+    char const* p = first;
+
+    while (p < last)
+    {
+        if (isSpace(*p) or *p == '\x1e')
+            ++p;
+        else if (isComment(p, last))
+            p = skipComment(p, last);
+        else
+            break;
+    }
+
+    return p;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*
+ * Only balances the brackets: whether the document is well formed is left to
+ * the parser. A record separator always ends the document, so a truncated
+ * record does not swallow the next one.
+ */
+char const* findDocumentEnd(char const* first, char const* last)
+{
+    char const* p = first;
+    Uint depth = 0;
+    bool scalar = false;
+
+    while (p < last)
+    {
+        char c = *p;
+
+        if (c == '\x1e')
+            break;
+        else if (scalar and (isSpace(c) or c == '"' or c == '{' or c == '[' or c == '/'))
+            break;
+        else if (c == '"')
+        {
+            p = skipString(p + 1, last);
+
+            if (depth == 0)
+                break;
+        }
+        else if (isComment(p, last))
+            p = skipComment(p, last);
+        else if (c == '{' or c == '[')
+        {
+            ++depth;
+            ++p;
+        }
+        else if (c == '}' or c == ']')
+        {
+            ++p;
+
+            if (depth == 0 or --depth == 0)
+                break;
+        }
+        else
+        {
+            scalar = scalar or (depth == 0 and not isSpace(c));
+            ++p;
+        }
+    }
+
+    return p;
+}
+
+}  // namespace
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+BatchParser::BatchParser(Uint num_threads, Uint batch_size) :
+        m_num_threads(num_threads),
+        m_batch_size(batch_size)
+{
+    if (m_num_threads == 0)
+        m_num_threads = std::max(1U, std::thread::hardware_concurrency());
+
+    if (m_batch_size == 0)
+        m_batch_size = 1;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+BatchParser::~BatchParser()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+
+    m_wake.notify_all();
+
+    for (std::thread& worker : m_workers)
+        worker.join();
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void BatchParser::setFormat(Format format)
+{
+    m_format = format;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void BatchParser::setErrorPolicy(ErrorPolicy policy)
+{
+    m_policy = policy;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+BatchParser::Format BatchParser::format() const
+{
+    return m_format;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+BatchParser::ErrorPolicy BatchParser::errorPolicy() const
+{
+    return m_policy;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+Uint BatchParser::numThreads() const
+{
+    return m_num_threads;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool BatchParser::parse(char const* first, char const* last, std::vector<Value>* result, ParseError* error)
+{
+    check_and_return_val(result != null, false);
+
+    std::vector<StringView> documents;
+
+    findDocuments(first, last, m_format, &documents);
+
+    Uint count = documents.size();
+    std::vector<Value> values(count);
+    std::vector<ParseError> errors(count);
+    std::atomic<Uint> next(0);
+    std::atomic<Uint> stop(count);
+
+    auto worker = [&]()
+    {
+        while (true)
+        {
+            Uint begin = next.fetch_add(m_batch_size);
+            Uint end = std::min(count, begin + m_batch_size);
+
+            if (begin >= count or begin > stop.load(std::memory_order_relaxed))
+                break;
+
+            for (Uint ix = begin; ix < end; ++ix)
+            {
+                StringView const& doc = documents[ix];
+
+                if (values[ix].parseData(doc.data, doc.data + doc.length, &errors[ix]))
+                    continue;
+
+                errors[ix].offset += size_t(doc.data - first);
+
+                if (m_policy == policyStop)
+                {
+                    Uint current = stop.load();
+
+                    while (ix < current and not stop.compare_exchange_weak(current, ix))
+                        ;
+
+                    break;
+                }
+            }
+        }
+    };
+
+    run(worker, std::min(m_num_threads, (count + m_batch_size - 1) / m_batch_size));
+
+    Uint num_kept = 0;
+
+    m_num_failed = 0;
+
+    if (error)
+        error->clear();
+
+    for (Uint ix = 0; ix < count; ++ix)
+    {
+        if (errors[ix])
+        {
+            if (error and m_num_failed == 0)
+                *error = errors[ix];
+
+            ++m_num_failed;
+
+            if (m_policy == policyStop)
+                break;
+            else if (m_policy == policySkip)
+                continue;
+        }
+
+        if (num_kept != ix)
+            values[num_kept].swap(values[ix]);
+
+        ++num_kept;
+    }
+
+    values.resize(num_kept);
+    result->swap(values);
+
+    return (m_policy != policyStop or m_num_failed == 0);
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*
+ * Runs the job on this thread and on the workers at once and returns when
+ * all of them are done. Every worker runs it, so the job has to share out
+ * the work by itself; workers that find nothing left return at once.
+ */
+void BatchParser::run(std::function<void()> const& job, Uint num_threads)
+{
+    if (num_threads < 2)
+    {
+        job();
+        return;
+    }
+
+    while (m_workers.size() + 1 < num_threads)
+        m_workers.emplace_back(&BatchParser::workerLoop, this, m_generation);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_job = &job;
+        m_num_busy = m_workers.size();
+        ++m_generation;
+    }
+
+    m_wake.notify_all();
+    job();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this] { return m_num_busy == 0; });
+    m_job = null;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void BatchParser::workerLoop(Uint generation)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (true)
+    {
+        m_wake.wait(lock, [&] { return m_stopping or m_generation != generation; });
+
+        if (m_stopping)
+            break;
+
+        std::function<void()> const* job = m_job;
+
+        generation = m_generation;
+        lock.unlock();
+        (*job)();
+        lock.lock();
+
+        if (--m_num_busy == 0)
+            m_done.notify_one();
+    }
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+Uint BatchParser::numFailed() const
+{
+    return m_num_failed;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void BatchParser::findDocuments(char const* first, char const* last, Format format, std::vector<StringView>* result)
+{
+    check_and_return(result != null);
+
+    char const* p = first;
+
+    result->clear();
+
+    while (p < last)
+    {
+        char const* end = null;
+
+        if (format == formatLines)
+        {
+            end = static_cast<char const*>(::memchr(p, '\n', last - p));
+            end = (end ? end : last);
+
+            if (skipSeparators(p, end) != end)
+                result->emplace_back(p, end - p);
+
+            p = end + (end < last ? 1 : 0);
+        }
+        else
+        {
+            p = skipSeparators(p, last);
+
+            if (p == last)
+                break;
+
+            end = findDocumentEnd(p, last);
+            result->emplace_back(p, end - p);
+            p = end;
+        }
+    }
+}
+
+}  // namespace json
@@ -0,0 +1,197 @@
+/*
+ * jsonbind.cpp
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "json/jsonbind.h"
+
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+
+namespace json {
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool BindingBase::setMismatch(Scanner& scanner)
+{
+    switch (scanner.peek())
+    {
+        case '{': case '[': case '"': case 't': case 'f': case 'n': case '-':
+        case '0': case '1': case '2': case '3': case '4':
+        case '5': case '6': case '7': case '8': case '9':
+            return scanner.setError(ParseError::errorTypeMismatch);
+
+        case '\0':
+            return scanner.setError(scanner.atEnd() ? ParseError::errorUnexpectedEnd : ParseError::errorUnexpectedNull);
+
+        default:
+            return scanner.setError(ParseError::errorUnexpectedSymbol);
+    }
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*
+ * Keys usually come in the order of the members, so the one after the last
+ * match is tried first. Returns count when there is no such member.
+ */
+Uint BindingBase::findField(StringView const* names, Uint count, StringView key, Uint hint)
+{
+    if (hint < count and names[hint].length == key.length and ::memcmp(names[hint].data, key.data, key.length) == 0)
+        return hint;
+
+    for (Uint ix = 0; ix < count; ++ix)
+    {
+        if (names[ix].length == key.length and ::memcmp(names[ix].data, key.data, key.length) == 0)
+            return ix;
+    }
+
+    return count;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*
+ * Converts a run of decimal digits; anything else, or a value that does not
+ * fit 64 bits, fails.
+ */
+bool BindingBase::readUnsigned(char const* first, char const* last, unsigned long long* value)
+{
+    unsigned long long result = 0;
+
+    if (first == last)
+        return false;
+
+    for (char const* p = first; p < last; ++p)
+    {
+        unsigned digit = *p - '0';
+
+        if (digit > 9 or result > (ULLONG_MAX - digit) / 10)
+            return false;
+
+        result = result * 10 + digit;
+    }
+
+    *value = result;
+
+    return true;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void BindingBase::writeString(std::string* result, char const* str, Uint length)
+{
+    result->push_back('"');
+    Value::appendEscaped(result, str, length);
+    result->push_back('"');
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void BindingBase::writeInteger(std::string* result, Integer value)
+{
+    char buf[32];
+    result->append(buf, ::snprintf(buf, sizeof(buf), "%lld", value));
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void BindingBase::writeUnsigned(std::string* result, unsigned long long value)
+{
+    char buf[32];
+    result->append(buf, ::snprintf(buf, sizeof(buf), "%llu", value));
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void BindingBase::writeDouble(std::string* result, double value)
+{
+    char buf[Number::formatSize];
+    result->append(buf, Number::format(value, buf));
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*
+ * The compact form of Value::saveToString(): no spaces, and untyped items of
+ * a container are left out the same way.
+ */
+void BindingBase::writeValue(std::string* result, Value const& value)
+{
+    std::string str;
+    bool has_prev = false;
+
+    switch (value.type())
+    {
+        case Value::typeString:
+            value.dumpInternal(&str, false, true, 0);
+            result->push_back('"');
+            result->append(str);
+            result->push_back('"');
+            break;
+
+        case Value::typeArray:
+            result->push_back('[');
+
+            for (const_iterator it = value.begin(); it != value.end(); ++it)
+            {
+                if (it->empty())
+                    continue;
+
+                if (has_prev)
+                    result->push_back(',');
+
+                writeValue(result, *it);
+                has_prev = true;
+            }
+
+            result->push_back(']');
+            break;
+
+        case Value::typeMap:
+            result->push_back('{');
+
+            for (const_iterator it = value.begin(); it != value.end(); ++it)
+            {
+                if (it->empty())
+                    continue;
+
+                char const* key = value.getKey(it);
+
+                if (has_prev)
+                    result->push_back(',');
+
+                writeString(result, key, ::strlen(key));
+                result->push_back(':');
+                writeValue(result, *it);
+                has_prev = true;
+            }
+
+            result->push_back('}');
+            break;
+
+        default:
+            if (value.dumpInternal(&str, false, true, 0))
+                result->append(str);
+            else
+                result->append("null");
+    }
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+}  // namespace json
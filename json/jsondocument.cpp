@@ -0,0 +1,139 @@
+/*
+ * jsondocument.cpp
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "json/jsondocument.h"
+
+#include <new>
+
+namespace json {
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+Document::Document(size_t block_size, bool huge_pages) :
+        m_arena(block_size, huge_pages),
+        m_keys(&m_arena)
+{
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+Document::Document(void* buffer, size_t size) :
+        m_arena(buffer, size),
+        m_keys(&m_arena)
+{
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+Document::~Document()
+{
+    // Nothing in the tree owns memory outside of the arena
+    ::new(&m_root) Value;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Grammar>
+bool Document::parse(char const* first, char const* last, ParseError* error, bool raw_numbers)
+{
+    clear();
+
+    if (m_root.parseInternal<Grammar>(first, last, false, &m_arena, m_intern_strings, &keyPool(), error, raw_numbers))
+        return true;
+
+    clear();
+
+    return false;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Grammar>
+bool Document::parseInSitu(char* first, char* last, ParseError* error, bool raw_numbers)
+{
+    clear();
+
+    if (m_root.parseInternal<Grammar>(first, last, true, &m_arena, m_intern_strings, &keyPool(), error, raw_numbers))
+        return true;
+
+    clear();
+
+    return false;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template bool Document::parse<StrictGrammar>(char const* first, char const* last, ParseError* error, bool raw_numbers);
+template bool Document::parse<RelaxedGrammar>(char const* first, char const* last, ParseError* error, bool raw_numbers);
+template bool Document::parseInSitu<StrictGrammar>(char* first, char* last, ParseError* error, bool raw_numbers);
+template bool Document::parseInSitu<RelaxedGrammar>(char* first, char* last, ParseError* error, bool raw_numbers);
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool Document::parseString(std::string const& data, ParseError* error, bool raw_numbers)
+{
+    return parse(data.c_str(), data.c_str() + data.size(), error, raw_numbers);
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void Document::setInternStrings(bool intern)
+{
+    m_intern_strings = intern;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool Document::internStrings() const
+{
+    return m_intern_strings;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void Document::setKeyPool(KeyPool* pool)
+{
+    m_shared_keys = pool;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+KeyPool& Document::keyPool()
+{
+    return (m_shared_keys ? *m_shared_keys : m_keys);
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+Value const& Document::root() const
+{
+    return m_root;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+Arena const& Document::arena() const
+{
+    return m_arena;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void Document::clear()
+{
+    ::new(&m_root) Value;
+    m_keys.clear();
+    m_arena.release();
+}
+
+}  // namespace json
@@ -0,0 +1,128 @@
+/*
+ * jsonerror.cpp
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "json/json.h"
+
+namespace json {
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+ParseError::ParseError()
+{
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+ParseError::ParseError(Code code_, size_t offset_) :
+        code(code_),
+        offset(offset_)
+{
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+ParseError::operator bool() const
+{
+    return (code != errorNone);
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool ParseError::operator!() const
+{
+    return (code == errorNone);
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+char const* ParseError::message() const
+{
+    switch (code)
+    {
+        case errorNone:
+            return "No error";
+        case errorUnexpectedEnd:
+            return "Unexpected end of data";
+        case errorUnexpectedSymbol:
+            return "Unexpected symbol";
+        case errorUnexpectedNull:
+            return "Unexpected null character";
+        case errorInvalidLiteral:
+            return "Invalid literal";
+        case errorInvalidNumber:
+            return "Invalid number";
+        case errorInvalidEscape:
+            return "Invalid escape sequence";
+        case errorInvalidUtf8:
+            return "Invalid UTF-8 sequence";
+        case errorExpectedString:
+            return "Expected '\"'";
+        case errorExpectedColon:
+            return "Expected ':'";
+        case errorUnterminatedComment:
+            return "Unexpected end of the comment";
+        case errorDepthLimit:
+            return "Nesting is too deep";
+        case errorTypeMismatch:
+            return "Value does not match the bound type";
+        case errorAborted:
+            return "Parsing aborted by the handler";
+        default:
+            return "Unknown error";
+    }
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void ParseError::position(char const* first, Uint* line, Uint* column) const
+{
+    Uint current_line = 1;
+    Uint current_column = 1;
+
+    for (size_t ix = 0; first and ix < offset; ++ix)
+    {
+        if (first[ix] == '\n')
+        {
+            ++current_line;
+            current_column = 1;
+        }
+        else
+            ++current_column;
+    }
+
+    if (line)
+        *line = current_line;
+
+    if (column)
+        *column = current_column;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void ParseError::clear()
+{
+    code = errorNone;
+    offset = 0;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+}  // namespace json
+
+
@@ -0,0 +1,600 @@
+/*
+ * jsonindex.cpp
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "json/jsonindex.h"
+
+#include <memory.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+#if defined(__x86_64__) || defined(__i386__)
+#  include <immintrin.h>
+#  define JSON_INDEX_X86 1
+#endif
+
+namespace json {
+
+#define BLOCK_SIZE 64
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+namespace {
+
+struct BlockMasks
+{
+    uint64_t quote;
+    uint64_t backslash;
+    uint64_t space;
+    uint64_t op;
+    uint64_t slash;
+};
+
+struct BlockState
+{
+    uint64_t prev_escaped = 0;
+    uint64_t prev_in_string = 0;
+    uint64_t prev_scalar = 0;
+    char     comment = 0;
+    bool     star = false;
+};
+
+typedef void (*ClassifyFunc)(char const* block, BlockMasks* masks);
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#ifndef JSON_INDEX_X86
+
+enum
+{
+    classQuote = 1,
+    classBackslash = 2,
+    classSpace = 4,
+    classOp = 8,
+    classSlash = 16,
+    classExtraSpace = 32
+};
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+struct ClassTable
+{
+    unsigned char value[256];
+
+    ClassTable()
+    {
+        ::memset(value, 0, sizeof(value));
+
+        value[(unsigned char) '"'] = classQuote;
+        value[(unsigned char) '\\'] = classBackslash;
+        value[(unsigned char) '/'] = classSlash;
+
+        for (char c : { '{', '}', '[', ']', ':', ',' })
+            value[(unsigned char) c] = classOp;
+
+        for (char c : { ' ', '\t', '\n', '\r' })
+            value[(unsigned char) c] = classSpace;
+
+        for (char c : { '\v', '\f', '\b' })
+            value[(unsigned char) c] = classExtraSpace;
+    }
+};
+
+static ClassTable const char_classes;
+
+
+template<typename Grammar>
+void classifyScalar(char const* block, BlockMasks* masks)
+{
+    ::memset(masks, 0, sizeof(*masks));
+
+    for (int ix = 0; ix < BLOCK_SIZE; ++ix)
+    {
+        uint64_t bit = uint64_t(1) << ix;
+
+        switch (char_classes.value[(unsigned char) block[ix]])
+        {
+            case classQuote:
+                masks->quote |= bit;
+                break;
+            case classBackslash:
+                masks->backslash |= bit;
+                break;
+            case classSpace:
+                masks->space |= bit;
+                break;
+            case classOp:
+                masks->op |= bit;
+                break;
+            case classSlash:
+                masks->slash |= bit;
+                break;
+            case classExtraSpace:
+                if (Grammar::allowExtraSpaces)
+                    masks->space |= bit;
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+#else /* JSON_INDEX_X86 */
+
+inline uint64_t movemask16(__m128i a, __m128i b, __m128i c, __m128i d)
+{
+    return  (uint64_t(uint16_t(_mm_movemask_epi8(a))) <<  0) |
+            (uint64_t(uint16_t(_mm_movemask_epi8(b))) << 16) |
+            (uint64_t(uint16_t(_mm_movemask_epi8(c))) << 32) |
+            (uint64_t(uint16_t(_mm_movemask_epi8(d))) << 48);
+}
+
+
+inline __m128i matchChar16(__m128i v, char c)
+{
+    return _mm_cmpeq_epi8(v, _mm_set1_epi8(c));
+}
+
+
+inline __m128i matchOp16(__m128i v)
+{
+    /* '[' | 0x20 == '{' and ']' | 0x20 == '}' */
+    __m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+    __m128i brackets = _mm_or_si128(matchChar16(lower, '{'), matchChar16(lower, '}'));
+    __m128i others = _mm_or_si128(matchChar16(v, ','), matchChar16(v, ':'));
+
+    return _mm_or_si128(brackets, others);
+}
+
+
+template<typename Grammar>
+inline __m128i matchSpace16(__m128i v)
+{
+    if (not Grammar::allowExtraSpaces)
+        return _mm_or_si128(_mm_or_si128(matchChar16(v, ' '), matchChar16(v, '\t')),
+                            _mm_or_si128(matchChar16(v, '\n'), matchChar16(v, '\r')));
+
+    /* ' ' and the range '\b'..'\r' */
+    __m128i shifted = _mm_sub_epi8(v, _mm_set1_epi8('\b'));
+    __m128i in_range = _mm_cmpeq_epi8(_mm_min_epu8(shifted, _mm_set1_epi8('\r' - '\b')), shifted);
+
+    return _mm_or_si128(in_range, matchChar16(v, ' '));
+}
+
+
+template<typename Grammar>
+void classifySse2(char const* block, BlockMasks* masks)
+{
+    __m128i v0 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(block +  0));
+    __m128i v1 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(block + 16));
+    __m128i v2 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(block + 32));
+    __m128i v3 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(block + 48));
+
+    masks->quote = movemask16(matchChar16(v0, '"'), matchChar16(v1, '"'),
+                              matchChar16(v2, '"'), matchChar16(v3, '"'));
+    masks->backslash = movemask16(matchChar16(v0, '\\'), matchChar16(v1, '\\'),
+                                  matchChar16(v2, '\\'), matchChar16(v3, '\\'));
+    masks->slash = movemask16(matchChar16(v0, '/'), matchChar16(v1, '/'),
+                              matchChar16(v2, '/'), matchChar16(v3, '/'));
+    masks->op = movemask16(matchOp16(v0), matchOp16(v1), matchOp16(v2), matchOp16(v3));
+    masks->space = movemask16(matchSpace16<Grammar>(v0), matchSpace16<Grammar>(v1),
+                              matchSpace16<Grammar>(v2), matchSpace16<Grammar>(v3));
+}
+
+
+__attribute__((target("avx2")))
+inline uint64_t movemask32(__m256i lo, __m256i hi)
+{
+    return  (uint64_t(uint32_t(_mm256_movemask_epi8(lo))) <<  0) |
+            (uint64_t(uint32_t(_mm256_movemask_epi8(hi))) << 32);
+}
+
+
+__attribute__((target("avx2")))
+inline __m256i matchChar32(__m256i v, char c)
+{
+    return _mm256_cmpeq_epi8(v, _mm256_set1_epi8(c));
+}
+
+
+__attribute__((target("avx2")))
+inline __m256i matchOp32(__m256i v)
+{
+    __m256i lower = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+    __m256i brackets = _mm256_or_si256(matchChar32(lower, '{'), matchChar32(lower, '}'));
+    __m256i others = _mm256_or_si256(matchChar32(v, ','), matchChar32(v, ':'));
+
+    return _mm256_or_si256(brackets, others);
+}
+
+
+template<typename Grammar>
+__attribute__((target("avx2")))
+inline __m256i matchSpace32(__m256i v)
+{
+    if (not Grammar::allowExtraSpaces)
+        return _mm256_or_si256(_mm256_or_si256(matchChar32(v, ' '), matchChar32(v, '\t')),
+                               _mm256_or_si256(matchChar32(v, '\n'), matchChar32(v, '\r')));
+
+    __m256i shifted = _mm256_sub_epi8(v, _mm256_set1_epi8('\b'));
+    __m256i in_range = _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, _mm256_set1_epi8('\r' - '\b')), shifted);
+
+    return _mm256_or_si256(in_range, matchChar32(v, ' '));
+}
+
+
+template<typename Grammar>
+__attribute__((target("avx2")))
+void classifyAvx2(char const* block, BlockMasks* masks)
+{
+    __m256i lo = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(block +  0));
+    __m256i hi = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(block + 32));
+
+    masks->quote = movemask32(matchChar32(lo, '"'), matchChar32(hi, '"'));
+    masks->backslash = movemask32(matchChar32(lo, '\\'), matchChar32(hi, '\\'));
+    masks->slash = movemask32(matchChar32(lo, '/'), matchChar32(hi, '/'));
+    masks->op = movemask32(matchOp32(lo), matchOp32(hi));
+    masks->space = movemask32(matchSpace32<Grammar>(lo), matchSpace32<Grammar>(hi));
+}
+
+#endif /* not JSON_INDEX_X86 */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Grammar>
+ClassifyFunc selectClassifier()
+{
+#ifdef JSON_INDEX_X86
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2"))
+        return classifyAvx2<Grammar>;
+
+    return classifySse2<Grammar>;
+#else
+    return classifyScalar<Grammar>;
+#endif
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+inline uint64_t prefixXor(uint64_t bits)
+{
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+
+    return bits;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+inline uint64_t findEscaped(uint64_t backslash, uint64_t& prev_escaped)
+{
+    uint64_t const even_bits = 0x5555555555555555ULL;
+
+    backslash &= ~prev_escaped;
+
+    uint64_t follows_escape = (backslash << 1) | prev_escaped;
+    uint64_t odd_starts = backslash & ~even_bits & ~follows_escape;
+    uint64_t even_sequences;
+
+    /* an odd run of backslashes escapes the character right after it */
+    prev_escaped = __builtin_add_overflow(odd_starts, backslash, &even_sequences);
+
+    uint64_t invert_mask = even_sequences << 1;
+
+    return (even_bits ^ invert_mask) & follows_escape;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Grammar>
+inline bool findStructurals(BlockState& state, BlockMasks const& masks, uint64_t& result, bool& plain)
+{
+    uint64_t prev_escaped = state.prev_escaped;
+    uint64_t escaped = findEscaped(masks.backslash, prev_escaped);
+    uint64_t quote = masks.quote & ~escaped;
+    uint64_t in_string = prefixXor(quote) ^ state.prev_in_string;
+
+    /* a '"' inside of a comment must not start a string: walkBlock() */
+    if (Grammar::allowComments and (state.comment or (masks.slash & ~in_string)))
+        return false;
+
+    if ((masks.backslash | masks.slash) & ~in_string)
+        plain = false;
+
+    state.prev_escaped = prev_escaped;
+    state.prev_in_string = uint64_t(int64_t(in_string) >> 63);
+
+    uint64_t scalar = ~(masks.op | masks.space | masks.quote | in_string);
+    uint64_t scalar_start = scalar & ~((scalar << 1) | state.prev_scalar);
+
+    state.prev_scalar = scalar >> 63;
+    result = (masks.op & ~in_string) | (quote & in_string) | scalar_start;
+
+    return true;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*
+ * findStructurals() one byte at a time, for the blocks with a comment. The
+ * comments end where Scanner::skipComment() ends them; only their first '/'
+ * is indexed, for the scanner to stop there and skip it. `next` is the byte
+ * after the block.
+ */
+template<typename Grammar>
+uint64_t walkBlock(char const* block, Uint count, char next, BlockState& state, bool& plain)
+{
+    bool in_string = state.prev_in_string;
+    bool escaped = state.prev_escaped;
+    bool scalar = state.prev_scalar;
+    uint64_t result = 0;
+
+    for (Uint ix = 0; ix < count; ++ix)
+    {
+        char c = block[ix];
+        uint64_t bit = uint64_t(1) << ix;
+
+        if (escaped)
+        {
+            escaped = false;
+            state.star = false;
+
+            if (in_string or state.comment)
+                continue;
+        }
+
+        if (state.comment)
+        {
+            if (c == '\\')
+                escaped = true;
+            else if (state.comment == '/' ? c == '\n' : (state.star and c == '/'))
+                state.comment = 0;
+
+            state.star = (state.comment == '*' and c == '*');
+            continue;
+        }
+
+        if (in_string)
+        {
+            if (c == '\\')
+                escaped = true;
+            else if (c == '"')
+                in_string = false;
+
+            continue;
+        }
+
+        char kind = (ix + 1 < count ? block[ix + 1] : next);
+
+        if (c == '"')
+        {
+            in_string = true;
+            result |= bit;
+            scalar = false;
+        }
+        else if (c == '{' or c == '}' or c == '[' or c == ']' or c == ':' or c == ',')
+        {
+            result |= bit;
+            scalar = false;
+        }
+        else if (c == ' ' or c == '\t' or c == '\n' or c == '\r'
+                 or (Grammar::allowExtraSpaces and (c == '\v' or c == '\f' or c == '\b')))
+        {
+            scalar = false;
+        }
+        else if (Grammar::allowComments and c == '/' and (kind == '/' or kind == '*'))
+        {
+            /* the second byte of the opening is skipped as escaped */
+            state.comment = kind;
+            escaped = true;
+            result |= bit;
+            scalar = false;
+            plain = false;
+        }
+        else
+        {
+            if (not scalar)
+                result |= bit;
+
+            if (c == '/' or c == '\\')
+                plain = false;
+
+            scalar = true;
+        }
+    }
+
+    state.prev_in_string = (in_string ? ~uint64_t(0) : 0);
+    state.prev_escaped = escaped;
+    state.prev_scalar = scalar;
+
+    return result;
+}
+
+}  // namespace
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+StructuralIndex::StructuralIndex()
+{
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+StructuralIndex::StructuralIndex(StructuralIndex&& other)
+{
+    swap(other);
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+StructuralIndex::~StructuralIndex()
+{
+    if (m_data)
+        ::free(m_data);
+
+    m_data = null;
+    m_num_items = 0;
+    m_allocated_size = 0;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+StructuralIndex& StructuralIndex::operator=(StructuralIndex&& other)
+{
+    swap(other);
+    return *this;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Grammar>
+bool StructuralIndex::build(char const* first, char const* last)
+{
+    static ClassifyFunc const classify = selectClassifier<Grammar>();
+
+    clear();
+
+    if (first == null or last < first or Uint(last - first) != size_t(last - first) or
+            Uint(last - first) == Uint(-1))
+        return false;
+
+    Uint length = last - first;
+    Uint offset = 0;
+    BlockState state;
+    BlockMasks masks;
+    uint64_t bits;
+
+    reserve(length / 4 + BLOCK_SIZE + 1);
+
+    while (offset < length)
+    {
+        char padded[BLOCK_SIZE];
+        char const* block = first + offset;
+
+        if (length - offset < BLOCK_SIZE)
+        {
+            ::memset(padded, ' ', BLOCK_SIZE);
+            ::memcpy(padded, block, length - offset);
+            block = padded;
+        }
+
+        classify(block, &masks);
+
+        if (not findStructurals<Grammar>(state, masks, bits, m_plain))
+        {
+            Uint count = std::min<Uint>(length - offset, BLOCK_SIZE);
+
+            bits = walkBlock<Grammar>(block, count, (count < length - offset ? block[count] : 0), state, m_plain);
+        }
+
+        if (m_num_items + BLOCK_SIZE + 1 > m_allocated_size)
+            reserve((m_allocated_size * 3) / 2 + BLOCK_SIZE + 1);
+
+        Uint* out = m_data + m_num_items;
+
+        while (bits)
+        {
+            *out++ = offset + __builtin_ctzll(bits);
+            bits &= bits - 1;
+        }
+
+        m_num_items = out - m_data;
+        offset += BLOCK_SIZE;
+    }
+
+    m_data[m_num_items++] = length;
+
+    return true;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void StructuralIndex::swap(StructuralIndex& other)
+{
+    std::swap(m_data, other.m_data);
+    std::swap(m_num_items, other.m_num_items);
+    std::swap(m_allocated_size, other.m_allocated_size);
+    std::swap(m_plain, other.m_plain);
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void StructuralIndex::clear()
+{
+    m_num_items = 0;
+    m_plain = true;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool StructuralIndex::empty() const
+{
+    return (m_num_items == 0);
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool StructuralIndex::plain() const
+{
+    return m_plain;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+Uint StructuralIndex::numItems() const
+{
+    return m_num_items;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+Uint const* StructuralIndex::data() const
+{
+    return m_data;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+Uint const* StructuralIndex::begin() const
+{
+    return m_data;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+Uint const* StructuralIndex::end() const
+{
+    return m_data + m_num_items;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void StructuralIndex::reserve(Uint new_size)
+{
+    if (new_size <= m_allocated_size)
+        return;
+
+    void* mem = ::realloc(m_data, sizeof(*m_data) * new_size);
+
+    assert(mem != null);
+
+    m_data = static_cast<Uint*>(mem);
+    m_allocated_size = new_size;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template bool StructuralIndex::build<StrictGrammar>(char const* first, char const* last);
+template bool StructuralIndex::build<RelaxedGrammar>(char const* first, char const* last);
+
+}  // namespace json
+
+
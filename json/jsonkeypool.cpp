@@ -0,0 +1,175 @@
+/*
+ * jsonkeypool.cpp
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "json/jsonkeypool.h"
+
+#include <string.h>
+
+namespace json {
+
+#define OWN_ARENA_BLOCK_SIZE    (4 * 1024)
+#define INITIAL_TABLE_SIZE      64
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+KeyPool::KeyPool(Arena* arena, bool synchronized) :
+        m_own_arena(OWN_ARENA_BLOCK_SIZE),
+        m_arena(arena ? arena : &m_own_arena),
+        m_synchronized(synchronized)
+{
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+Key KeyPool::intern(char const* str, Uint length)
+{
+    std::unique_lock<std::mutex> lock(m_mutex, std::defer_lock);
+
+    if (m_synchronized)
+        lock.lock();
+
+    Uint code = Map::hashCode(str, length);
+    Key const* found = lookup(str, length, code);
+
+    if (found and found->data)
+        return *found;
+
+    if (m_keys.empty() or (m_num_keys + 1) * 4 > m_keys.size() * 3)
+    {
+        grow();
+        found = lookup(str, length, code);
+    }
+
+    Key* key = const_cast<Key*>(found);
+
+    key->data = m_arena->copyString(str, length);
+    key->length = length;
+    key->code = code;
+    ++m_num_keys;
+
+    return *key;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+Key KeyPool::intern(char const* str)
+{
+    return intern(str, ::strlen(str));
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+Key KeyPool::find(char const* str, Uint length) const
+{
+    std::unique_lock<std::mutex> lock(m_mutex, std::defer_lock);
+
+    if (m_synchronized)
+        lock.lock();
+
+    Key const* found = lookup(str, length, Map::hashCode(str, length));
+
+    return (found and found->data ? *found : Key());
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+Key KeyPool::find(char const* str) const
+{
+    return find(str, ::strlen(str));
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+Uint KeyPool::numKeys() const
+{
+    return m_num_keys;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void KeyPool::clear()
+{
+    // Maps anywhere in the process may borrow its keys
+    check_and_return(this != &global(), "the global key pool is never cleared");
+
+    std::unique_lock<std::mutex> lock(m_mutex, std::defer_lock);
+
+    if (m_synchronized)
+        lock.lock();
+
+    m_keys.clear();
+    m_num_keys = 0;
+    m_own_arena.release();
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+KeyPool& KeyPool::global()
+{
+    static KeyPool pool(null, true);
+    return pool;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*
+ * The slot of the key, or the free slot where it belongs; null while the
+ * table is empty.
+ */
+Key const* KeyPool::lookup(char const* str, Uint length, Uint code) const
+{
+    if (m_keys.empty())
+        return null;
+
+    Uint mask = m_keys.size() - 1;
+
+    for (Uint ix = code & mask; ; ix = (ix + 1) & mask)
+    {
+        Key const& key = m_keys[ix];
+
+        if (key.data == null)
+            return &key;
+
+        if (key.code == code and key.length == length and ::memcmp(key.data, str, length) == 0)
+            return &key;
+    }
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void KeyPool::grow()
+{
+    std::vector<Key> keys(m_keys.empty() ? INITIAL_TABLE_SIZE : m_keys.size() * 2);
+    Uint mask = keys.size() - 1;
+
+    for (Key const& key : m_keys)
+    {
+        if (key.data == null)
+            continue;
+
+        Uint ix = key.code & mask;
+
+        while (keys[ix].data != null)
+            ix = (ix + 1) & mask;
+
+        keys[ix] = key;
+    }
+
+    m_keys.swap(keys);
+}
+
+}  // namespace json
@@ -0,0 +1,674 @@
+/*
+ * jsonlazy.cpp
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "json/jsonlazy.h"
+#include "json/jsonscanner.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <cassert>
+#include <type_traits>
+
+namespace json {
+
+namespace {
+
+inline bool isSpace(char c)
+{
+    return c == ' ' or (c >= '\b' and c <= '\r');
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*
+ * The first '/' or '\\' outside of a string, which leaves the structural index
+ * not plain, or last if there is none.
+ */
+char const* findUnquoted(char const* first, char const* last)
+{
+    char const* p = first;
+
+    while (p < last)
+    {
+        if (*p == '"')
+        {
+            for (++p; p < last and *p != '"'; ++p)
+            {
+                if (*p == '\\')
+                    ++p;
+            }
+
+            ++p;
+        }
+        else if (*p == '/' or *p == '\\')
+            return p;
+        else
+            ++p;
+    }
+
+    return last;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+inline bool isComment(char const* p, char const* last)
+{
+    return p[0] == '/' and p + 1 < last and (p[1] == '/' or p[1] == '*');
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*
+ * Overwrites the comments with spaces, so the structural index can be built
+ * and every offset stays the same as in the original input.
+ */
+bool blankComments(char* first, char* last, ParseError* error)
+{
+    char* p = first;
+
+    while (p < last)
+    {
+        if (*p == '"')
+        {
+            for (++p; p < last and *p != '"'; ++p)
+            {
+                if (*p == '\\')
+                    ++p;
+            }
+
+            ++p;
+        }
+        else if (*p != '/')
+            ++p;
+        else if (p + 1 < last and (p[1] == '/' or p[1] == '*'))
+        {
+            char kind = p[1];
+            bool closed = false;
+
+            *p++ = ' ';
+            *p++ = ' ';
+
+            while (p < last and not closed)
+            {
+                if (*p == '\\' and p + 1 < last)
+                    *p++ = ' ';
+                else if (kind == '/' and *p == '\n')
+                    break;
+                else if (kind == '*' and *p == '*' and p + 1 < last and p[1] == '/')
+                {
+                    *p++ = ' ';
+                    closed = true;
+                }
+
+                *p++ = ' ';
+            }
+
+            if (kind == '*' and not closed)
+            {
+                *error = ParseError(ParseError::errorUnterminatedComment, last - first);
+                return false;
+            }
+        }
+        else
+        {
+            *error = ParseError(ParseError::errorUnexpectedSymbol, p - first);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+}  // namespace
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+LazyValue::LazyValue()
+{
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+LazyValue::LazyValue(LazyDocument const* document, Uint entry) :
+        m_document(document),
+        m_entry(entry)
+{
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+Value::Type LazyValue::type() const
+{
+    if (m_document == null)
+        return Value::untyped;
+
+    char const* first = m_document->m_first + m_document->position(m_entry);
+    char const* last = m_document->m_first + m_document->end(m_entry);
+
+    switch (*first)
+    {
+        case '{':
+            return Value::typeMap;
+        case '[':
+            return Value::typeArray;
+        case '"':
+            return Value::typeString;
+        case 't':
+            return (last - first == 4 and ::memcmp(first, "true", 4) == 0 ? Value::typeBoolean : Value::untyped);
+        case 'f':
+            return (last - first == 5 and ::memcmp(first, "false", 5) == 0 ? Value::typeBoolean : Value::untyped);
+        case 'n':
+            return (last - first == 4 and ::memcmp(first, "null", 4) == 0 ? Value::typeNull : Value::untyped);
+        default:
+        {
+            Scanner scanner(first, last);
+            Number number;
+
+            bool ok = (m_document->m_strict ? scanner.readNumber<StrictGrammar>(&number) : scanner.readNumber(&number));
+
+            if (not ok or not scanner.atEnd())
+                return Value::untyped;
+
+            return (number.type == Number::typeInteger ? Value::typeInteger : Value::typeDouble);
+        }
+    }
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool LazyValue::isUsed() const
+{
+    return (type() != Value::untyped);
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool LazyValue::isNull() const
+{
+    return (type() == Value::typeNull);
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool LazyValue::isBoolean() const
+{
+    return (type() == Value::typeBoolean);
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool LazyValue::isInteger() const
+{
+    return (type() == Value::typeInteger);
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool LazyValue::isDouble() const
+{
+    return (type() == Value::typeDouble);
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool LazyValue::isString() const
+{
+    return (type() == Value::typeString);
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool LazyValue::isArray() const
+{
+    return (type() == Value::typeArray);
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool LazyValue::isMap() const
+{
+    return (type() == Value::typeMap);
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+Uint LazyValue::size() const
+{
+    if (m_document == null)
+        return 0;
+
+    LazyDocument const* doc = m_document;
+    char kind = doc->at(m_entry);
+    Uint entry = m_entry + 1;
+    Uint count = 0;
+
+    if (kind == '[')
+    {
+        while (doc->isValue(entry))
+        {
+            ++count;
+            entry = doc->skip(entry);
+
+            if (doc->at(entry) != ',')
+                break;
+
+            ++entry;
+        }
+    }
+    else if (kind == '{')
+    {
+        while (doc->at(entry) == '"' and doc->at(entry + 1) == ':' and doc->isValue(entry + 2))
+        {
+            ++count;
+            entry = doc->skip(entry + 2);
+
+            if (doc->at(entry) != ',')
+                break;
+
+            ++entry;
+        }
+    }
+
+    return count;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool LazyValue::hasKey(char const* key) const
+{
+    return find(key, key ? ::strlen(key) : 0).m_document != null;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool LazyValue::hasKey(std::string const& key) const
+{
+    return find(key.c_str(), key.size()).m_document != null;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+LazyValue LazyValue::operator[](char const* key) const
+{
+    return find(key, key ? ::strlen(key) : 0);
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+LazyValue LazyValue::operator[](std::string const& key) const
+{
+    return find(key.c_str(), key.size());
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+LazyValue LazyValue::operator[](int ix) const
+{
+    if (m_document == null or ix < 0 or m_document->at(m_entry) != '[')
+        return LazyValue();
+
+    LazyDocument const* doc = m_document;
+    Uint entry = m_entry + 1;
+
+    while (doc->isValue(entry))
+    {
+        if (ix-- == 0)
+            return LazyValue(doc, entry);
+
+        entry = doc->skip(entry);
+
+        if (doc->at(entry) != ',')
+            break;
+
+        ++entry;
+    }
+
+    return LazyValue();
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool LazyValue::asBoolean() const
+{
+    Value::Type tp = type();
+
+    if (tp == Value::typeMap or tp == Value::typeArray)
+        return (size() > 0);
+
+    return toValue().asBoolean();
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+Integer LazyValue::asInteger() const
+{
+    Value::Type tp = type();
+
+    if (tp == Value::typeMap or tp == Value::typeArray)
+        return size();
+
+    return toValue().asInteger();
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+double LazyValue::asDouble() const
+{
+    Value::Type tp = type();
+
+    if (tp == Value::typeMap or tp == Value::typeArray)
+        return size();
+
+    return toValue().asDouble();
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+std::string LazyValue::asString() const
+{
+    return toValue().asString();
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+StringView LazyValue::raw() const
+{
+    if (m_document == null)
+        return StringView();
+
+    Uint first = m_document->position(m_entry);
+
+    return StringView(m_document->m_first + first, m_document->end(m_entry) - first);
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+Value LazyValue::toValue() const
+{
+    Value result;
+    StringView text = raw();
+
+    if (text.data and m_document->m_strict)
+        result.parseData<StrictGrammar>(text.data, text.data + text.length);
+    else if (text.data)
+        result.parseData(text.data, text.data + text.length);
+
+    return result;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+LazyValue LazyValue::find(char const* key, Uint length) const
+{
+    if (m_document == null or key == null or m_document->at(m_entry) != '{')
+        return LazyValue();
+
+    LazyDocument const* doc = m_document;
+    Uint entry = m_entry + 1;
+
+    while (doc->at(entry) == '"' and doc->at(entry + 1) == ':' and doc->isValue(entry + 2))
+    {
+        if (doc->keyEquals(entry, key, length))
+            return LazyValue(doc, entry + 2);
+
+        entry = doc->skip(entry + 2);
+
+        if (doc->at(entry) != ',')
+            break;
+
+        ++entry;
+    }
+
+    return LazyValue();
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+LazyDocument::LazyDocument()
+{
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+LazyDocument::~LazyDocument()
+{
+    clear();
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool LazyDocument::parse(char const* first, char const* last, ParseError* error)
+{
+    return parse<RelaxedGrammar>(first, last, error);
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool LazyDocument::parse(std::string const& data, ParseError* error)
+{
+    return parse<RelaxedGrammar>(data.data(), data.data() + data.size(), error);
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*
+ * The index is built straight from the input; only when it is not plain
+ * because of a comment the grammar allows is the input copied with the
+ * comments blanked.
+ */
+template<typename Grammar>
+bool LazyDocument::parse(char const* first, char const* last, ParseError* error)
+{
+    clear();
+
+    m_first = first;
+    m_last = last;
+    m_strict = std::is_same<Grammar, StrictGrammar>::value;
+
+    if (m_index.build<Grammar>(first, last) and m_index.plain())
+        return matchBrackets(error);
+
+    char const* p = findUnquoted(first, last);
+
+    if (not Grammar::allowComments or p == last or not isComment(p, last))
+        return indexFailed(error);
+
+    Uint length = last - first;
+    void* mem = ::malloc(sizeof(char) * (length + 1));
+
+    assert(mem != null);
+
+    m_buffer = static_cast<char*>(mem);
+    ::memcpy(m_buffer, first, length);
+    m_buffer[length] = '\0';
+    m_first = m_buffer;
+    m_last = m_buffer + length;
+
+    ParseError result;
+
+    if (not blankComments(m_buffer, m_buffer + length, &result))
+        return setError(error, result.code, result.offset);
+
+    if (not m_index.build<Grammar>(m_first, m_last) or not m_index.plain())
+        return indexFailed(error);
+
+    return matchBrackets(error);
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void LazyDocument::clear()
+{
+    ::free(m_buffer);
+
+    m_buffer = null;
+    m_first = null;
+    m_last = null;
+    m_strict = false;
+    m_index.clear();
+    m_match.clear();
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+LazyValue LazyDocument::root() const
+{
+    return (m_index.numItems() > 1 ? LazyValue(this, 0) : LazyValue());
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+LazyValue LazyDocument::operator[](char const* key) const
+{
+    return root()[key];
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+LazyValue LazyDocument::operator[](std::string const& key) const
+{
+    return root()[key];
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+LazyValue LazyDocument::operator[](int ix) const
+{
+    return root()[ix];
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*
+ * Pairs every opening bracket with its closing one, so that skip() jumps over
+ * a container of any size in one step.
+ */
+bool LazyDocument::matchBrackets(ParseError* error)
+{
+    Uint terminator = m_index.numItems() - 1;
+    std::vector<Uint> stack;
+
+    if (terminator == 0)
+        return setError(error, ParseError::errorUnexpectedEnd, m_last - m_first);
+
+    m_match.assign(terminator, 0);
+
+    for (Uint entry = 0; entry < terminator; ++entry)
+    {
+        char c = at(entry);
+
+        if (c == '{' or c == '[')
+            stack.push_back(entry);
+        else if (c == '}' or c == ']')
+        {
+            if (stack.empty() or at(stack.back()) != (c == '}' ? '{' : '['))
+                return setError(error, ParseError::errorUnexpectedSymbol, position(entry));
+
+            m_match[stack.back()] = entry;
+            stack.pop_back();
+        }
+
+        if (stack.empty() and entry + 1 < terminator)
+            return setError(error, ParseError::errorUnexpectedSymbol, position(entry + 1));
+    }
+
+    if (not stack.empty())
+        return setError(error, ParseError::errorUnexpectedEnd, m_last - m_first);
+
+    if (error)
+        error->clear();
+
+    return true;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*
+ * Reports why the structural index could not be used: a stray '/' or '\\',
+ * or input too large for 32-bit offsets.
+ */
+bool LazyDocument::indexFailed(ParseError* error)
+{
+    char const* p = findUnquoted(m_first, m_last);
+
+    if (p != m_last)
+        return setError(error, ParseError::errorUnexpectedSymbol, p - m_first);
+    else if (m_first == m_last)
+        return setError(error, ParseError::errorUnexpectedEnd, 0);
+    else
+        return setError(error, ParseError::errorUnexpectedSymbol, Uint(-1));
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool LazyDocument::setError(ParseError* error, ParseError::Code code, Uint offset)
+{
+    clear();
+
+    if (error)
+        *error = ParseError(code, offset);
+
+    return false;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+inline char LazyDocument::at(Uint entry) const
+{
+    Uint pos = position(entry);
+
+    return (m_first + pos < m_last ? m_first[pos] : '\0');
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+inline Uint LazyDocument::position(Uint entry) const
+{
+    return m_index.data()[entry];
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool LazyDocument::isValue(Uint entry) const
+{
+    char c = at(entry);
+
+    return c != '\0' and c != '}' and c != ']' and c != ',' and c != ':';
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+Uint LazyDocument::skip(Uint entry) const
+{
+    Uint terminator = m_index.numItems() - 1;
+    char c = at(entry);
+
+    if (entry >= terminator)
+        return terminator;
+
+    return (c == '{' or c == '[' ? m_match[entry] + 1 : entry + 1);
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*
+ * Offset just past the value: past the closing bracket of a container or the
+ * last non-blank byte before the next structural token.
+ */
+Uint LazyDocument::end(Uint entry) const
+{
+    char c = at(entry);
+
+    if (c == '{' or c == '[')
+        return position(m_match[entry]) + 1;
+
+    Uint first = position(entry);
+    Uint last = position(skip(entry));
+
+    while (last > first + 1 and isSpace(m_first[last - 1]))
+        --last;
+
+    return last;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool LazyDocument::keyEquals(Uint entry, char const* key, Uint length) const
+{
+    char const* first = m_first + position(entry) + 1;
+    char const* last = m_first + end(entry) - 1;
+
+    if (last < first or *last != '"')
+        return false;
+
+    if (::memchr(first, '\\', last - first) == null)
+        return (Uint(last - first) == length and ::memcmp(first, key, length) == 0);
+
+    Scanner scanner(first - 1, last + 1);
+    StringView str;
+
+    return scanner.readString(&str) and str.length == length and ::memcmp(str.data, key, length) == 0;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template bool LazyDocument::parse<StrictGrammar>(char const* first, char const* last, ParseError* error);
+template bool LazyDocument::parse<RelaxedGrammar>(char const* first, char const* last, ParseError* error);
+
+}  // namespace json
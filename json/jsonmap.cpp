@@ -26,6 +26,7 @@
 
 
 #include "json/jsonmap.h"
+#include "json/jsonarena.h"
 
 #include <memory.h>
 #include <stdlib.h>
@@ -33,22 +34,79 @@
 #include <cassert>
 #include <cstdlib>
 #include <cstring>
+#include <new>
 #include <utility>
 
+#if defined(__SSE2__)
+#  include <emmintrin.h>
+#  define JSON_MAP_SSE2 1
+#endif
+
 
 namespace json {
 
-//------------------------------------------------------------------------------
-//------------------------------------------------------------------------------
-Map::Map(Uint initial_buckets_count)
+#define CONTROL_EMPTY   0x80
+#define TAG_BITS        7
+#define MIN_SLOTS       8
+
+namespace {
+
+/*
+ * Bit i is set when the control byte of slot first + i matches; the 16 bytes
+ * are always there thanks to the copy of the first ones after the index.
+ */
+inline Uint matchTag(unsigned char const* control, unsigned char tag)
 {
-    setBucketsCount(initial_buckets_count ? initial_buckets_count : 1);
+#ifdef JSON_MAP_SSE2
+    __m128i group = _mm_loadu_si128(reinterpret_cast<__m128i const*>(control));
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(tag)));
+#else
+    Uint result = 0;
+
+    for (Uint ix = 0; ix < Map::group_size; ++ix)
+        result |= Uint(control[ix] == tag) << ix;
+
+    return result;
+#endif
+}
+
+
+inline Uint matchEmpty(unsigned char const* control)
+{
+#ifdef JSON_MAP_SSE2
+    return _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(control)));
+#else
+    Uint result = 0;
+
+    for (Uint ix = 0; ix < Map::group_size; ++ix)
+        result |= Uint(control[ix] == CONTROL_EMPTY) << ix;
+
+    return result;
+#endif
+}
+
+
+/*
+ * At most 7/8 of the slots are used, and at least one is always free, which
+ * ends every probe. This is also the room for items.
+ */
+inline Uint maxItems(Uint capacity)
+{
+    return capacity - std::max(capacity / 8, Uint(1));
+}
+
+}  // namespace
+
+
+Map::Map(Uint initial_size, Arena* arena)
+{
+    allocate(slotsFor(initial_size), arena);
 }
 
 
 Map::Map(std::initializer_list<std::pair<char const*, Value>> const& list)
 {
-    setBucketsCount(10);
+    allocate(slotsFor(list.size()), null);
 
     for (auto it : list)
         (*this)[it.first] = it.second;
@@ -70,26 +128,22 @@ Map::Map(Map const& other)
 Map::~Map()
 {
     Uint ix;
-    Uint last = capacity();
+    Uint last = numItems();
 
     for (ix = 0; ix < last; ++ix)
         clear(ix);
 
-    if (m_keys)
-        ::free(m_keys);
-
-    if (m_codes)
-        ::free(m_codes);
-
-    if (m_values)
+    if (not m_external)
         ::free(m_values);
 
+    m_values = null;
     m_keys = null;
     m_codes = null;
-    m_values = null;
+    m_borrowed = null;
+    m_index = null;
+    m_control = null;
     m_num_items = 0;
-    m_num_buckets = 0;
-    m_capacity = 0;
+    m_num_slots = 0;
 }
 
 
@@ -119,27 +173,26 @@ void Map::swap(Map& other)
     std::swap(m_values, other.m_values);
     std::swap(m_keys, other.m_keys);
     std::swap(m_codes, other.m_codes);
-    std::swap(m_capacity, other.m_capacity);
-    std::swap(m_num_buckets, other.m_num_buckets);
+    std::swap(m_borrowed, other.m_borrowed);
+    std::swap(m_index, other.m_index);
+    std::swap(m_control, other.m_control);
+    std::swap(m_num_slots, other.m_num_slots);
     std::swap(m_num_items, other.m_num_items);
+    std::swap(m_external, other.m_external);
 }
 
 
 void Map::assign(Map const& other)
 {
-    Map tmp(other.capacity());
+    Map tmp(other.numItems());
     Uint ix;
 
-    for (ix = 0; ix < other.capacity(); ++ix)
+    for (ix = 0; ix < other.numItems(); ++ix)
     {
-        if (other.itemIsUsed(ix))
-        {
-            tmp.setKey(ix, other.m_keys[ix], other.m_codes[ix]);
-            tmp.m_values[ix] = other.m_values[ix];
-        }
+        Value copy(other.m_values[ix]);
+        tmp.insertRaw(other.m_codes[ix], other.m_keys[ix], &copy);
     }
 
-    tmp.m_num_items = other.numItems();
     swap(tmp);
 }
 
@@ -152,13 +205,16 @@ Uint Map::numItems() const
 
 Uint Map::capacity() const
 {
-    return m_capacity;
+    return (m_num_slots ? maxItems(m_num_slots) : 0);
 }
 
 
-Uint Map::numBuckets() const
+void Map::reserve(Uint num_items, Arena* arena)
 {
-    return this->m_num_buckets;
+    Uint num_slots = slotsFor(num_items);
+
+    if (num_slots > m_num_slots)
+        rehash(num_slots, arena);
 }
 
 
@@ -168,46 +224,35 @@ bool Map::hasKey(char const* key) const
 }
 
 
-void Map::getKeys(std::vector<char const*>* result) const
+bool Map::hasKey(Key const& key) const
 {
-    Uint first, last;
-    char const* str;
-
-    last = capacity();
+    return (key.data != null and find(key.code, key.data) != null);
+}
 
-    result->clear();
-    result->resize(numItems());
 
-    for (first = 0; first < last; ++first)
-    {
-        if (m_keys[first])
-        {
-            str = m_keys[first];
-            result->push_back(str);
-        }
-    }
+void Map::getKeys(std::vector<char const*>* result) const
+{
+    result->assign(m_keys, m_keys + numItems());
 }
 
 
 char const* Map::getKey(json::const_iterator iter) const
 {
     Uint index = iter - begin();
-    return (index < capacity() ? m_keys[index] : null);
+    return (index < numItems() ? m_keys[index] : null);
 }
 
 
 bool Map::remove(char const* key)
 {
-    Value* value = const_cast<Value*>(find(key));
+    Uint slot = findSlot(getHashCode(key), key);
 
-    if (value)
-    {
-        Uint index = value - m_values;
-        clear(index);
-        --m_num_items;
-    }
+    if (slot == m_num_slots)
+        return false;
 
-    return (value != null);
+    erase(slot);
+
+    return true;
 }
 
 
@@ -239,50 +284,71 @@ void Map::insert(std::string const& key, Value const& value)
 }
 
 
-void Map::setBucketsCount(Uint new_buckets_count)
+Value& Map::insertBorrowed(char const* key, Arena* arena)
 {
-    void* mem;
-    Uint real_new_size;
-    bool force_reset = (m_values == null);
-
-    if (new_buckets_count == numBuckets() and not force_reset)
-        return;
+    Uint hash_key = getHashCode(key);
+    Value const* value = find(hash_key, key);
 
-    if (new_buckets_count < numBuckets())
+    if (value)
+        return *const_cast<Value*>(value);
+    else
     {
-        Uint index = numBuckets() * Map::bucket_size;
+        Value dummy;
+        return *insertRaw(hash_key, key, &dummy, true, arena);
+    }
+}
 
-        while (index < capacity())
-        {
-            m_num_items -= itemIsUsed(index);
-            clear(index);
-        }
+
+Value& Map::insertBorrowed(Key const& key, Arena* arena)
+{
+    assert(key.data != null);
+
+    Value const* value = find(key.code, key.data);
+
+    if (value)
+        return *const_cast<Value*>(value);
+    else
+    {
+        Value dummy;
+        return *insertRaw(key.code, key.data, &dummy, true, arena);
     }
+}
 
-    real_new_size = new_buckets_count * Map::bucket_size + 1;
 
-    mem = ::realloc(m_values, sizeof(*m_values) * real_new_size);
-    assert(mem != null);
-    m_values = static_cast<Value*>(mem);
+/*
+ * One block for everything: the values with an empty one past the end for
+ * failed const lookups, the keys, their codes and borrowed flags, then the
+ * index with its control bytes, followed by a copy of the first group_size
+ * of them.
+ */
+void Map::allocate(Uint num_slots, Arena* arena)
+{
+    Uint num_entries = maxItems(num_slots);
+    size_t values_size = sizeof(*m_values) * (num_entries + 1);
+    size_t keys_size = sizeof(*m_keys) * num_entries;
+    size_t codes_size = sizeof(*m_codes) * num_entries;
+    size_t index_size = sizeof(*m_index) * num_slots;
+    size_t control_size = num_slots + group_size;
+    size_t size = values_size + keys_size + codes_size + index_size + control_size + num_entries;
+    char* mem = static_cast<char*>(arena ? arena->allocate(size) : ::malloc(size));
 
-    mem = ::realloc(m_keys, sizeof(*m_keys) * real_new_size);
     assert(mem != null);
-    m_keys = static_cast<char**>(mem);
 
-    mem = ::realloc(m_codes, sizeof(*m_codes) * real_new_size);
-    assert(mem != null);
-    m_codes = static_cast<Uint*>(mem);
+    ::memset(mem, 0, values_size + keys_size);
 
-    if (new_buckets_count > numBuckets() or force_reset)
-    {
-        Uint rest = real_new_size - capacity();
-        ::memset(m_values + capacity(), 0, sizeof(*m_values) * rest);
-        ::memset(m_keys + capacity(), 0, sizeof(*m_keys) * rest);
-        ::memset(m_codes + capacity(), 0, sizeof(*m_codes) * rest);
-    }
+    m_values = reinterpret_cast<Value*>(mem);
+    m_keys = reinterpret_cast<char**>(mem + values_size);
+    m_codes = reinterpret_cast<Uint*>(mem + values_size + keys_size);
+    m_index = reinterpret_cast<Uint*>(mem + values_size + keys_size + codes_size);
+    m_control = reinterpret_cast<unsigned char*>(m_index + num_slots);
+    m_borrowed = reinterpret_cast<bool*>(m_control + control_size);
 
-    m_num_buckets = new_buckets_count;
-    m_capacity = real_new_size - 1;
+    ::memset(m_control, CONTROL_EMPTY, control_size);
+    ::memset(m_borrowed, 0, num_entries);
+
+    m_num_slots = num_slots;
+    m_num_items = 0;
+    m_external = (arena != null);
 }
 
 
@@ -307,6 +373,22 @@ Value& Map::operator[](std::string const& key)
 }
 
 
+Value& Map::operator[](Key const& key)
+{
+    assert(key.data != null);
+
+    Value const* value = find(key.code, key.data);
+
+    if (value)
+        return *const_cast<Value*>(value);
+    else
+    {
+        Value dummy;
+        return *insertRaw(key.code, key.data, &dummy);
+    }
+}
+
+
 Value const& Map::operator[](char const* key) const
 {
     Uint hash_key = getHashCode(key);
@@ -325,6 +407,14 @@ Value const& Map::operator[](std::string const& key) const
 }
 
 
+Value const& Map::operator[](Key const& key) const
+{
+    Value const* value = (key.data ? find(key.code, key.data) : null);
+
+    return (value ? *value : m_values[capacity()]);
+}
+
+
 json::iterator Map::begin()
 {
     return m_values;
@@ -333,7 +423,7 @@ json::iterator Map::begin()
 
 json::iterator Map::end()
 {
-    return m_values + capacity();
+    return m_values + numItems();
 }
 
 
@@ -345,69 +435,74 @@ json::const_iterator Map::begin() const
 
 json::const_iterator Map::end() const
 {
-    return m_values + capacity();
+    return m_values + numItems();
 }
 
 
-inline Value* Map::insertRaw(Uint hash_key, char const* key, Value* value)
+/*
+ * The same code as getHashCode() for a string without NUL characters.
+ */
+Uint Map::hashCode(char const* str, Uint length)
 {
-    Uint index, last;
+    Uint hash_key = 0;
 
-    hashCodeToIndex(hash_key, &index, &last);
+    for (Uint ix = 0; ix < length; ++ix)
+        hash_key = ((hash_key << 5) + hash_key) + str[ix];
 
-    while (index < last)
-    {
-        if (not itemIsUsed(index))
-        {
-            setKey(index, key, hash_key);
-            m_values[index].swap(*value);
-            ++m_num_items;
+    return hash_key;
+}
 
-            return m_values + index;
-        }
 
-        ++index;
-    }
+inline Value* Map::insertRaw(Uint hash_key, char const* key, Value* value, bool borrowed, Arena* arena)
+{
+    if (m_num_items + 1 > capacity())
+        rehash(m_num_slots * 2, arena);
 
-    Uint num_buckets = numBuckets();
-    Uint bucket_to, item_to, item_to_last, item_from, bucket_from;
+    Uint slot = findFree(hash_key);
+    Uint index = m_num_items;
 
-    setBucketsCount((num_buckets * 3) / 2 + 1);
+    m_index[slot] = index;
+    setControl(slot, mixCode(hash_key) & ((1 << TAG_BITS) - 1));
+    setKey(index, key, hash_key, borrowed);
+    m_values[index].swap(*value);
+    ++m_num_items;
 
-    for (bucket_from = 0; bucket_from < num_buckets; ++bucket_from)
-    {
-        for (item_from = 0; item_from < Map::bucket_size; ++item_from)
-        {
-            index = bucket_from * Map::bucket_size + item_from;
+    return m_values + index;
+}
 
-            if (not itemIsUsed(index))
-                continue;
 
-            bucket_to = m_codes[index] % numBuckets();
+void Map::rehash(Uint num_slots, Arena* arena)
+{
+    Value* values = m_values;
+    char** keys = m_keys;
+    Uint* codes = m_codes;
+    bool* borrowed = m_borrowed;
+    Uint num_items = numItems();
+    bool external = m_external;
+    Uint ix;
 
-            if (bucket_to == bucket_from)
-                continue;
+    allocate(std::max(num_slots, Uint(MIN_SLOTS)), arena);
 
-            item_to = bucket_to * Map::bucket_size;
-            item_to_last = item_to + Map::bucket_size;
+    if (values == null)
+        return;
 
-            for (; item_to < item_to_last; ++item_to)
-            {
-                if (not itemIsUsed(item_to))
-                {
-                    std::swap(m_codes[item_from], m_codes[item_to]);
-                    std::swap(m_keys[item_from], m_keys[item_to]);
-                    m_values[item_from].swap(m_values[item_to]);
-                    break;
-                }
-            }
+    ::memcpy(m_keys, keys, sizeof(*m_keys) * num_items);
+    ::memcpy(m_codes, codes, sizeof(*m_codes) * num_items);
+    ::memcpy(m_borrowed, borrowed, sizeof(*m_borrowed) * num_items);
 
-            if (item_to >= item_to_last)
-                return insertRaw(hash_key, key, value);
-        }
+    for (ix = 0; ix < num_items; ++ix)
+    {
+        Uint slot = findFree(m_codes[ix]);
+
+        m_index[slot] = ix;
+        setControl(slot, mixCode(m_codes[ix]) & ((1 << TAG_BITS) - 1));
+        m_values[ix].swap(values[ix]);
     }
 
-    return insertRaw(hash_key, key, value);
+    m_num_items = num_items;
+
+    if (not external)
+        ::free(values);
 }
 
 
@@ -419,52 +514,163 @@ inline Value const* Map::find(char const* key) const
 
 inline Value const* Map::find(Uint hash_key, char const* key) const
 {
-    Uint current, last;
+    Uint slot = findSlot(hash_key, key);
+    return (slot < m_num_slots ? &m_values[m_index[slot]] : null);
+}
+
+
+/*
+ * The slot of the key or m_num_slots. The key, if it is there, lies between
+ * its home slot and the first free one after it.
+ */
+inline Uint Map::findSlot(Uint hash_key, char const* key) const
+{
+    Uint mixed = mixCode(hash_key);
+    Uint mask = m_num_slots - 1;
+    unsigned char tag = mixed & ((1 << TAG_BITS) - 1);
+    Uint pos;
+
+    if (m_num_slots == 0)
+        return 0;
+
+    for (pos = (mixed >> TAG_BITS) & mask; ; pos = (pos + group_size) & mask)
+    {
+        unsigned char const* group = m_control + pos;
+        Uint matches = matchTag(group, tag);
+
+        while (matches)
+        {
+            Uint slot = (pos + __builtin_ctz(matches)) & mask;
+
+            if (itemEqual(m_index[slot], hash_key, key))
+                return slot;
+
+            matches &= matches - 1;
+        }
 
-    hashCodeToIndex(hash_key, &current, &last);
+        if (matchEmpty(group))
+            return m_num_slots;
+    }
+}
 
-    while (current < last)
+
+inline Uint Map::findFree(Uint hash_key) const
+{
+    Uint mask = m_num_slots - 1;
+    Uint pos;
+
+    for (pos = (mixCode(hash_key) >> TAG_BITS) & mask; ; pos = (pos + group_size) & mask)
     {
-        if (itemEqual(current, hash_key, key))
-            return &m_values[current];
-        ++current;
+        Uint empty = matchEmpty(m_control + pos);
+
+        if (empty)
+            return (pos + __builtin_ctz(empty)) & mask;
     }
+}
 
-    return null;
+
+/*
+ * The slot that holds the item number index, whose hash code is given; the
+ * item must be in the map.
+ */
+inline Uint Map::findIndex(Uint hash_key, Uint index) const
+{
+    Uint mixed = mixCode(hash_key);
+    Uint mask = m_num_slots - 1;
+    unsigned char tag = mixed & ((1 << TAG_BITS) - 1);
+    Uint pos;
+
+    for (pos = (mixed >> TAG_BITS) & mask; ; pos = (pos + group_size) & mask)
+    {
+        Uint matches = matchTag(m_control + pos, tag);
+
+        while (matches)
+        {
+            Uint slot = (pos + __builtin_ctz(matches)) & mask;
+
+            if (m_index[slot] == index)
+                return slot;
+
+            matches &= matches - 1;
+        }
+    }
 }
 
 
-inline void Map::hashCodeToIndex(Uint hash_key, Uint* first, Uint *last) const
+/*
+ * Frees the slot, moving every later slot of the probe run that may live in
+ * it back, so lookups never see a gap before their key. Then the items past
+ * the removed one move down to keep the order dense, and only their slots
+ * are renumbered.
+ */
+void Map::erase(Uint slot)
 {
-    Uint start = 0;
-    Uint end = 0;
+    Uint mask = m_num_slots - 1;
+    Uint index = m_index[slot];
+    Uint hole = slot;
+    Uint ix;
 
-    if (numBuckets())
+    for (ix = (slot + 1) & mask; m_control[ix] != CONTROL_EMPTY; ix = (ix + 1) & mask)
     {
-        start = (hash_key % numBuckets()) * Map::bucket_size;
-        end = start + Map::bucket_size;
+        Uint home = (mixCode(m_codes[m_index[ix]]) >> TAG_BITS) & mask;
+
+        if (((ix - home) & mask) < ((ix - hole) & mask))
+            continue;
 
+        m_index[hole] = m_index[ix];
+        setControl(hole, m_control[ix]);
+        hole = ix;
     }
 
-    if (first)
-        *first = start;
+    setControl(hole, CONTROL_EMPTY);
+
+    clear(index);
+    --m_num_items;
+
+    Uint rest = m_num_items - index;
+
+    ::memmove(static_cast<void*>(m_values + index), m_values + index + 1, sizeof(*m_values) * rest);
+    ::memmove(m_keys + index, m_keys + index + 1, sizeof(*m_keys) * rest);
+    ::memmove(m_codes + index, m_codes + index + 1, sizeof(*m_codes) * rest);
+    ::memmove(m_borrowed + index, m_borrowed + index + 1, sizeof(*m_borrowed) * rest);
+
+    ::new(&m_values[m_num_items]) Value;
+    m_keys[m_num_items] = null;
+    m_borrowed[m_num_items] = false;
+
+    for (ix = index; ix < m_num_items; ++ix)
+        m_index[findIndex(m_codes[ix], ix + 1)] = ix;
+}
+
+
+inline void Map::setControl(Uint slot, unsigned char control)
+{
+    Uint ix;
+
+    m_control[slot] = control;
 
-    if (last)
-        *last = end;
+    for (ix = slot + m_num_slots; ix < m_num_slots + group_size; ix += m_num_slots)
+        m_control[ix] = control;
 }
 
 
-void Map::setKey(Uint index, char const* key, Uint code)
+void Map::setKey(Uint index, char const* key, Uint code, bool borrowed)
 {
     char* str = m_keys[index];
 
-    if (str)
+    if (str and not m_borrowed[index])
         ::free(str);
 
     m_keys[index] = null;
     m_codes[index] = 0;
+    m_borrowed[index] = borrowed;
 
-    if (key)
+    if (key and borrowed)
+    {
+        m_keys[index] = const_cast<char*>(key);
+        m_codes[index] = code ? code : getHashCode(key);
+    }
+    else if (key)
     {
         int len = ::strlen(key);
         void* mem = ::malloc(sizeof(*str) * (len + 1));
@@ -483,23 +689,16 @@ void Map::setKey(Uint index, char const* key, Uint code)
 
 inline void Map::clear(Uint index)
 {
-    if (m_keys[index])
-    {
-        setKey(index, null, 0);
-        m_values[index].~Value();
-    }
+    setKey(index, null, 0);
+    m_values[index].~Value();
+    ::new(&m_values[index]) Value;
 }
 
 
 inline bool Map::itemEqual(Uint index, Uint hash_key, char const* key) const
 {
-    return (m_codes[index] == hash_key and strEquals(m_keys[index], key));
-}
-
-
-inline bool Map::itemIsUsed(Uint index) const
-{
-    return (index < capacity() and m_keys[index] != null);
+    return (m_codes[index] == hash_key and m_keys[index] != null
+            and (m_keys[index] == key or strEquals(m_keys[index], key)));
 }
 
 
@@ -524,12 +723,26 @@ inline bool Map::strEquals(char const* s1, char const* s2)
 }
 
 
-inline Uint Map::getIndex(Uint bucket_index, Uint item_index)
+/*
+ * Spreads the bits of a djb2 code, whose high bits stay zero for short keys,
+ * over the whole word.
+ */
+inline Uint Map::mixCode(Uint code)
 {
-    return bucket_index * Map::bucket_size + item_index;
+    code *= 0x9E3779B1u;
+    return code ^ (code >> 16);
 }
 
 
-}  // namespace json
+inline Uint Map::slotsFor(Uint num_items)
+{
+    Uint result = MIN_SLOTS;
+
+    while (maxItems(result) < num_items)
+        result *= 2;
 
+    return result;
+}
 
+
+}  // namespace json
@@ -0,0 +1,233 @@
+/*
+ * jsonparallel.cpp
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "json/jsonvalue.h"
+#include "json/jsonscanner.h"
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace json {
+
+#define PARALLEL_MIN_SIZE (1 << 20)
+#define PARALLEL_CHUNKS_PER_THREAD 8
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+namespace {
+
+/*
+ * One member of the top-level container: the offset of its key (objects
+ * only) and the range of its value, up to the comma or the closing bracket.
+ */
+struct Member
+{
+    Uint key;
+    Uint first;
+    Uint last;
+};
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*
+ * Walks the structural index of the top level only. Anything unusual makes it
+ * give up, and the sequential parser then reports the error where it is; so
+ * does nesting beyond JSON_MAX_DEPTH, which a member parsed on its own would
+ * measure from its own start.
+ */
+bool splitMembers(char const* data, StructuralIndex const& index, std::vector<Member>* result)
+{
+    Uint const* entries = index.data();
+    Uint terminator = index.numItems() - 1;
+    char open = data[entries[0]];
+    char close = (open == '{' ? '}' : ']');
+    Uint entry = 1;
+
+    if (open != '{' and open != '[')
+        return false;
+
+    while (entry < terminator and data[entries[entry]] != close)
+    {
+        Member member = { 0, 0, 0 };
+        Uint start = 0;
+        int depth = 0;
+
+        if (open == '{')
+        {
+            if (data[entries[entry]] != '"' or entry + 2 >= terminator or data[entries[entry + 1]] != ':')
+                return false;
+
+            member.key = entries[entry];
+            entry += 2;
+        }
+
+        start = entry;
+        member.first = entries[entry];
+
+        for (; entry < terminator; ++entry)
+        {
+            char c = data[entries[entry]];
+
+            if ((c == '{' or c == '[') and ++depth >= JSON_MAX_DEPTH)
+                return false;
+            else if ((c == '}' or c == ']') and --depth < 0)
+                break;
+            else if (c == ',' and depth == 0)
+                break;
+            else if (c == ':' and depth == 0)
+                return false;
+        }
+
+        if (entry >= terminator or entry == start)
+            return false;
+
+        member.last = entries[entry];
+        result->push_back(member);
+
+        if (data[entries[entry]] == ',')
+            ++entry;
+        else if (data[entries[entry]] != close)
+            return false;
+    }
+
+    return entry + 1 == terminator;
+}
+
+}  // namespace
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool Value::parseDataParallel(char const* first, char const* last, ParseError* error, Uint num_threads)
+{
+    StructuralIndex index;
+    std::vector<Member> members;
+
+    if (num_threads == 0)
+        num_threads = std::thread::hardware_concurrency();
+
+    if (num_threads < 2 or last - first < PARALLEL_MIN_SIZE or not index.build(first, last)
+        or not index.plain() or not splitMembers(first, index, &members))
+        return parseData(first, last, error);
+
+    bool is_map = (first[index.data()[0]] == '{');
+    Uint count = members.size();
+    Uint chunk_size = (last - first) / (num_threads * PARALLEL_CHUNKS_PER_THREAD) + 1;
+    std::vector<Uint> chunks;
+
+    chunks.push_back(0);
+
+    for (Uint ix = 1; ix < count; ++ix)
+    {
+        if (members[ix].first - members[chunks.back()].first >= chunk_size)
+            chunks.push_back(ix);
+    }
+
+    chunks.push_back(count);
+
+    Uint num_chunks = chunks.size() - 1;
+    Value val(is_map ? typeMap : typeArray);
+    std::vector<Value> values(is_map ? count : 0);
+    std::vector<std::string> keys(is_map ? count : 0);
+    std::vector<ParseError> errors(num_chunks);
+    std::atomic<Uint> next(0);
+    std::atomic<Uint> failed(num_chunks);
+
+    if (not is_map)
+        val.array().resize(count);
+
+    auto worker = [&]()
+    {
+        Uint chunk;
+
+        while ((chunk = next.fetch_add(1)) < num_chunks and chunk < failed.load(std::memory_order_relaxed))
+        {
+            for (Uint ix = chunks[chunk]; ix < chunks[chunk + 1]; ++ix)
+            {
+                Member const& member = members[ix];
+                Value& slot = (is_map ? values[ix] : val.array()[ix]);
+
+                if (is_map)
+                {
+                    Scanner scanner(first + member.key, first + member.first);
+                    StringView key;
+
+                    if (scanner.readString(&key))
+                        keys[ix].assign(key.data, key.length);
+                    else
+                    {
+                        scanner.getError(&errors[chunk]);
+                        errors[chunk].offset += member.key;
+                    }
+                }
+
+                if (not errors[chunk] and not slot.parseData(first + member.first, first + member.last, &errors[chunk]))
+                    errors[chunk].offset += member.first;
+
+                if (errors[chunk])
+                {
+                    Uint current = failed.load();
+
+                    while (chunk < current and not failed.compare_exchange_weak(current, chunk))
+                        ;
+
+                    break;
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+
+    for (Uint ix = 1; ix < std::min(num_threads, num_chunks); ++ix)
+        threads.emplace_back(worker);
+
+    worker();
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    if (failed < num_chunks)
+    {
+        if (error)
+            *error = errors[failed];
+
+        return false;
+    }
+
+    if (is_map)
+    {
+        Map& map = val.map();
+
+        for (Uint ix = 0; ix < count; ++ix)
+            map[keys[ix]].swap(values[ix]);
+    }
+
+    swap(val);
+
+    return true;
+}
+
+}  // namespace json
@@ -0,0 +1,670 @@
+/*
+ * jsonprojection.cpp
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "json/jsonprojection.h"
+#include "json/jsonscanner.h"
+
+#include <string.h>
+
+namespace json {
+
+/*
+ * Cursor of one parse() call and the nodes whose value has been seen. Once
+ * every path is resolved, skipping is set and the rest is only skipped with
+ * check_rest, or not read at all: stopped is set and every level returns.
+ */
+struct Projection::State
+{
+    char const*         first;
+    char const*         last;
+    char const*         current;
+    std::vector<char>   done;
+    bool                skipping = false;
+    bool                stopped = false;
+    bool                check_rest = false;
+    ParseError          error;
+
+    State(char const* first_, char const* last_, Uint num_nodes);
+
+    bool setError(ParseError::Code code);
+    bool setError(ParseError::Code code, size_t offset);
+
+    bool skipSpaces();
+    bool skipComment();
+    bool skipString();
+    bool skipValue();
+
+    static bool isSpace(char c);
+    static bool isScalarChar(char c);
+};
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+Projection::State::State(char const* first_, char const* last_, Uint num_nodes) :
+        first(first_),
+        last(last_),
+        current(first_),
+        done(num_nodes, 0)
+{
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool Projection::State::setError(ParseError::Code code)
+{
+    return setError(code, current - first);
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool Projection::State::setError(ParseError::Code code, size_t offset)
+{
+    if (not error)
+        error = ParseError(code, offset);
+
+    return false;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*
+ * Returns false only for a broken comment; the caller checks for the end.
+ */
+bool Projection::State::skipSpaces()
+{
+    while (current < last)
+    {
+        if (isSpace(*current))
+            ++current;
+        else if (*current == '/')
+        {
+            if (not skipComment())
+                return false;
+        }
+        else
+            break;
+    }
+
+    return true;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool Projection::State::skipComment()
+{
+    char kind = (current + 1 < last ? current[1] : '\0');
+
+    if (kind != '*' and kind != '/')
+        return setError(ParseError::errorUnexpectedSymbol);
+
+    for (current += 2; current < last; ++current)
+    {
+        if (*current == '\\')
+        {
+            if (++current == last)
+                break;
+        }
+        else if (kind == '/' and *current == '\n')
+        {
+            ++current;
+            return true;
+        }
+        else if (kind == '*' and *current == '*' and current + 1 < last and current[1] == '/')
+        {
+            current += 2;
+            return true;
+        }
+    }
+
+    current = last;
+
+    return (kind == '/' ? true : setError(ParseError::errorUnterminatedComment));
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool Projection::State::skipString()
+{
+    char const* p = current + 1;
+
+    while (p < last)
+    {
+        char const* quote = static_cast<char const*>(::memchr(p, '"', last - p));
+
+        if (quote == null)
+            break;
+
+        char const* back = quote;
+
+        while (back > p and back[-1] == '\\')
+            --back;
+
+        p = quote + 1;
+
+        if (((quote - back) & 1) == 0)
+        {
+            current = p;
+            return true;
+        }
+    }
+
+    current = last;
+
+    return setError(ParseError::errorUnexpectedEnd);
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*
+ * Moves past one value looking only at quotes and brackets: nothing inside is
+ * converted or checked.
+ */
+bool Projection::State::skipValue()
+{
+    char c = *current;
+
+    if (c == '"')
+        return skipString();
+
+    if (c != '{' and c != '[')
+    {
+        char const* start = current;
+
+        while (current < last and isScalarChar(*current))
+            ++current;
+
+        if (current == start)
+            return setError(c == '\0' ? ParseError::errorUnexpectedNull : ParseError::errorUnexpectedSymbol);
+
+        return true;
+    }
+
+    Uint depth = 0;
+
+    while (current < last)
+    {
+        switch (*current)
+        {
+            case '"':
+                if (not skipString())
+                    return false;
+                continue;
+
+            case '/':
+                if (current + 1 < last and (current[1] == '/' or current[1] == '*'))
+                {
+                    if (not skipComment())
+                        return false;
+                    continue;
+                }
+                break;
+
+            case '{':
+            case '[':
+                ++depth;
+                break;
+
+            case '}':
+            case ']':
+                if (--depth == 0)
+                {
+                    ++current;
+                    return true;
+                }
+                break;
+
+            default:
+                break;
+        }
+
+        ++current;
+    }
+
+    return setError(ParseError::errorUnexpectedEnd);
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+inline bool Projection::State::isSpace(char c)
+{
+    return c == ' ' or (c >= '\b' and c <= '\r');
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+inline bool Projection::State::isScalarChar(char c)
+{
+    return ((c | 0x20) >= 'a' and (c | 0x20) <= 'z') or (c >= '0' and c <= '9') or c == '.' or c == '+' or c == '-';
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+Projection::Projection() :
+        m_nodes(1)
+{
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+Projection::Projection(std::initializer_list<char const*> const& pointers) :
+        m_nodes(1)
+{
+    for (char const* pointer : pointers)
+        add(pointer);
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*
+ * Adds a path such as "/meta/id"; "~0" and "~1" stand for '~' and '/'.
+ * The empty pointer selects the whole document.
+ */
+bool Projection::add(char const* pointer)
+{
+    check_and_return_val(pointer != null, false);
+
+    if (*pointer != '\0' and *pointer != '/')
+        return false;
+
+    for (char const* p = pointer; *p; ++p)
+    {
+        if (*p == '~' and p[1] != '0' and p[1] != '1')
+            return false;
+    }
+
+    std::vector<Uint> nodes(1, 0);
+    std::vector<Uint> next;
+    char const* p = pointer;
+
+    while (*p == '/')
+    {
+        std::string token;
+
+        for (++p; *p and *p != '/'; ++p)
+        {
+            if (*p == '~')
+                token += (*++p == '0' ? '~' : '/');
+            else
+                token += *p;
+        }
+
+        next.clear();
+
+        for (Uint node : nodes)
+        {
+            next.push_back(addChild(node, token));
+
+            if (token == "*")
+            {
+                for (auto const& child : m_nodes[node].children)
+                    next.push_back(child.second);
+            }
+        }
+
+        nodes.swap(next);
+    }
+
+    for (Uint node : nodes)
+        m_nodes[node].terminal = true;
+
+    return true;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool Projection::add(std::string const& pointer)
+{
+    return add(pointer.c_str());
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void Projection::clear()
+{
+    m_nodes.assign(1, Node());
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool Projection::empty() const
+{
+    return m_nodes.size() == 1 and not m_nodes[0].terminal;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool Projection::parse(char const* first, char const* last, Value* result, ParseError* error, bool check_rest) const
+{
+    check_and_return_val(result != null, false);
+
+    if (m_nodes[0].terminal)
+        return result->parseData(first, last, error);
+
+    State state(first, last, m_nodes.size());
+    Value val;
+
+    state.check_rest = check_rest;
+
+    if (state.skipSpaces())
+    {
+        if (state.current == last)
+            state.setError(ParseError::errorUnexpectedEnd);
+        else if (parseValue(state, 0, &val) and not state.stopped and state.skipSpaces() and state.current != last)
+            state.setError(ParseError::errorUnexpectedSymbol);
+    }
+
+    if (error)
+        *error = state.error;
+
+    if (state.error)
+        return false;
+
+    result->swap(val);
+
+    return true;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool Projection::parse(std::string const& data, Value* result, ParseError* error, bool check_rest) const
+{
+    return parse(data.data(), data.data() + data.size(), result, error, check_rest);
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*
+ * Every named child also holds the paths of its wildcard sibling, so parsing
+ * follows a single node per key: a path through "*" is added below the named
+ * children too, and a new named child starts as a copy of the wildcard.
+ */
+Uint Projection::addChild(Uint node, std::string const& token)
+{
+    if (token == "*" and m_nodes[node].wildcard)
+        return m_nodes[node].wildcard;
+
+    for (auto const& child : m_nodes[node].children)
+    {
+        if (token != "*" and child.first == token)
+            return child.second;
+    }
+
+    Uint child = m_nodes.size();
+
+    m_nodes.emplace_back();
+
+    if (token == "*")
+        m_nodes[node].wildcard = child;
+    else
+    {
+        m_nodes[node].children.emplace_back(token, child);
+
+        if (m_nodes[node].wildcard)
+            merge(child, m_nodes[node].wildcard);
+    }
+
+    return child;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void Projection::merge(Uint target, Uint source)
+{
+    if (m_nodes[source].terminal)
+        m_nodes[target].terminal = true;
+
+    for (Uint ix = 0; ix < m_nodes[source].children.size(); ++ix)
+    {
+        std::string token = m_nodes[source].children[ix].first;
+        Uint from = m_nodes[source].children[ix].second;
+
+        merge(addChild(target, token), from);
+    }
+
+    if (m_nodes[source].wildcard)
+        merge(addChild(target, "*"), m_nodes[source].wildcard);
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+Uint Projection::findChild(Uint node, StringView key) const
+{
+    Node const& item = m_nodes[node];
+
+    for (auto const& child : item.children)
+    {
+        if (child.first.size() == key.length and ::memcmp(child.first.data(), key.data, key.length) == 0)
+            return child.second;
+    }
+
+    return item.wildcard;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*
+ * A path is resolved once the value at it or at one of its prefixes has been
+ * seen, except below a wildcard, which stays open until its container ends.
+ */
+bool Projection::resolved(State& state, Uint node) const
+{
+    Node const& item = m_nodes[node];
+
+    if (state.done[node])
+        return true;
+    else if (item.terminal or item.wildcard or item.children.empty())
+        return false;
+
+    for (auto const& child : item.children)
+    {
+        if (not resolved(state, child.second))
+            return false;
+    }
+
+    return true;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool Projection::parseValue(State& state, Uint node, Value* result) const
+{
+    char const* start = state.current;
+    bool ok = false;
+
+    if (m_nodes[node].terminal)
+    {
+        Value value;
+        ParseError error;
+
+        if (not state.skipValue())
+            return false;
+
+        if (not value.parseData(start, state.current, &error))
+            return state.setError(error.code, error.offset + (start - state.first));
+
+        result->swap(value);
+        ok = true;
+    }
+    else if (*start == '{')
+        ok = parseMap(state, node, result);
+    else if (*start == '[')
+        ok = parseArray(state, node, result);
+    else
+        ok = state.skipValue();
+
+    state.done[node] = ok;
+
+    return ok;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool Projection::parseMap(State& state, Uint node, Value* result) const
+{
+    ++state.current;
+
+    if (not state.skipSpaces())
+        return false;
+
+    while (state.current < state.last and *state.current != '}')
+    {
+        Uint child = 0;
+        std::string name;
+
+        if (*state.current != '"')
+            return state.setError(ParseError::errorExpectedString);
+
+        {
+            Scanner scanner(state.current, state.last);
+            StringView key;
+
+            if (not scanner.readString(&key))
+            {
+                ParseError error;
+                scanner.getError(&error);
+                return state.setError(error.code, error.offset + (state.current - state.first));
+            }
+
+            child = (state.skipping ? 0 : findChild(node, key));
+
+            if (child)
+                name.assign(key.data, key.length);
+
+            state.current += scanner.offset();
+        }
+
+        if (not state.skipSpaces())
+            return false;
+        else if (state.current == state.last)
+            return state.setError(ParseError::errorUnexpectedEnd);
+        else if (*state.current != ':')
+            return state.setError(ParseError::errorExpectedColon);
+
+        ++state.current;
+
+        if (not state.skipSpaces())
+            return false;
+        else if (state.current == state.last)
+            return state.setError(ParseError::errorUnexpectedEnd);
+
+        if (child)
+        {
+            Value value;
+
+            if (not parseValue(state, child, &value))
+                return false;
+
+            if (value.isUsed())
+            {
+                if (not result->isMap())
+                    *result = Value(Value::typeMap);
+
+                (*result)[name].swap(value);
+            }
+
+            state.skipping = resolved(state, 0);
+
+            if (state.skipping and not state.check_rest)
+                return (state.stopped = true);
+        }
+        else if (not state.skipValue())
+            return false;
+
+        if (not state.skipSpaces())
+            return false;
+        else if (state.current == state.last)
+            return state.setError(ParseError::errorUnexpectedEnd);
+
+        if (*state.current == ',')
+        {
+            ++state.current;
+
+            if (not state.skipSpaces())
+                return false;
+        }
+        else if (*state.current != '}')
+            return state.setError(ParseError::errorUnexpectedSymbol);
+    }
+
+    if (state.current == state.last)
+        return state.setError(ParseError::errorUnexpectedEnd);
+
+    ++state.current;
+
+    return true;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool Projection::parseArray(State& state, Uint node, Value* result) const
+{
+    bool indexed = not m_nodes[node].children.empty();
+    Uint index = 0;
+
+    ++state.current;
+
+    if (not state.skipSpaces())
+        return false;
+
+    while (state.current < state.last and *state.current != ']')
+    {
+        Uint child = (state.skipping ? 0 : m_nodes[node].wildcard);
+
+        if (indexed and not state.skipping)
+        {
+            std::string key = std::to_string(index);
+            child = findChild(node, StringView(key.data(), key.size()));
+        }
+
+        if (child)
+        {
+            Value value;
+
+            if (not parseValue(state, child, &value))
+                return false;
+
+            if (value.isUsed())
+            {
+                if (not result->isArray())
+                    *result = Value(Value::typeArray);
+
+                while (result->size() < index)
+                    (*result)[int(result->size())] = Value(Value::typeNull);
+
+                (*result)[int(index)].swap(value);
+            }
+
+            state.skipping = resolved(state, 0);
+
+            if (state.skipping and not state.check_rest)
+                return (state.stopped = true);
+        }
+        else if (not state.skipValue())
+            return false;
+
+        ++index;
+
+        if (not state.skipSpaces())
+            return false;
+        else if (state.current == state.last)
+            return state.setError(ParseError::errorUnexpectedEnd);
+
+        if (*state.current == ',')
+        {
+            ++state.current;
+
+            if (not state.skipSpaces())
+                return false;
+        }
+        else if (*state.current != ']')
+            return state.setError(ParseError::errorUnexpectedSymbol);
+    }
+
+    if (state.current == state.last)
+        return state.setError(ParseError::errorUnexpectedEnd);
+
+    ++state.current;
+
+    return true;
+}
+
+}  // namespace json
@@ -0,0 +1,689 @@
+/*
+ * jsonscanner.cpp
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "json/jsonscanner.h"
+#include "json/jsonutf8.h"
+
+#include <memory.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <cassert>
+
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
+
+namespace json {
+
+#define STRUCTURAL_INDEX_MIN_SIZE 1024
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+namespace {
+
+/*
+ * 0x80 in every byte of the word that is zero and 0 elsewhere, exactly.
+ */
+inline uint64_t zeroBytes(uint64_t word)
+{
+    uint64_t const low = 0x7f7f7f7f7f7f7f7fULL;
+
+    return ~(((word & low) + low) | word | low);
+}
+
+}  // namespace
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+Scanner::Scanner(char const* first, char const* last, bool in_situ) :
+        m_first(first),
+        m_last(last),
+        m_current(first),
+        m_in_situ(in_situ)
+{
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+Scanner::~Scanner()
+{
+    if (m_scratch)
+        ::free(m_scratch);
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Grammar>
+void Scanner::buildIndex()
+{
+    if (m_last - m_first >= STRUCTURAL_INDEX_MIN_SIZE and m_index.build<Grammar>(m_first, m_last))
+        m_structural = m_index.data();
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool Scanner::startsWith(char const* str, Uint length) const
+{
+    return (Uint(m_last - m_current) >= length and ::memcmp(m_current, str, length) == 0);
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool Scanner::readLiteral(char const* literal, Uint length)
+{
+    if (not startsWith(literal, length))
+        return setError(ParseError::errorInvalidLiteral);
+
+    m_current += length;
+
+    return true;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Grammar>
+bool Scanner::readString(StringView* result)
+{
+    if (peek() != '"')
+        return setError(ParseError::errorExpectedString);
+
+    char const* start = ++m_current;
+    char* out = const_cast<char*>(start);
+    bool escaped = false;
+
+    m_scratch_length = 0;
+
+    while (true)
+    {
+        bool non_ascii;
+        char const* run = m_current;
+        char const* stop = findStringSpecial<Grammar>(run, m_last, &non_ascii);
+        Uint count = stop - run;
+
+        if (non_ascii)
+        {
+            char const* invalid = findInvalidUtf8(run, stop);
+
+            if (invalid)
+            {
+                m_current = invalid;
+                return setError(ParseError::errorInvalidUtf8);
+            }
+        }
+
+        m_current = stop;
+
+        if (stop == m_last)
+            return setError(ParseError::errorUnexpectedEnd);
+        else if (*stop == '\0')
+            return setError(ParseError::errorUnexpectedNull);
+        else if (not Grammar::allowControlCharacters and static_cast<unsigned char>(*stop) < ' ')
+            return setError(ParseError::errorUnexpectedSymbol);
+
+        if (m_in_situ)
+        {
+            if (out != run)
+                ::memmove(out, run, count);
+
+            out += count;
+        }
+        else if (escaped or *stop == '\\')
+        {
+            appendScratch(run, count);
+            escaped = true;
+        }
+
+        if (*stop == '"')
+            break;
+
+        char buf[4];
+        int length = readEscape<Grammar>(buf);
+
+        if (length == 0)
+            return false;
+
+        if (m_in_situ)
+        {
+            ::memcpy(out, buf, length);
+            out += length;
+        }
+        else
+        {
+            appendScratch(buf, length);
+        }
+    }
+
+    if (m_in_situ)
+    {
+        *out = '\0';
+        *result = StringView(start, out - start);
+    }
+    else if (escaped)
+        *result = StringView(m_scratch, m_scratch_length);
+    else
+        *result = StringView(start, m_current - start);
+
+    ++m_current;
+
+    return true;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Grammar>
+bool Scanner::readNumber(Number* result)
+{
+    char const* end;
+
+    if (Grammar::allowHexNumbers and startsWith("0x", 2))
+        end = Number::parseHex(m_current, m_last, result);
+    else
+        end = Number::parse(m_current, m_last, result);
+
+    if (end == null)
+        return setError(ParseError::errorInvalidNumber);
+
+    m_current = end;
+
+    return true;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Grammar>
+bool Scanner::skipString()
+{
+    if (peek() != '"')
+        return setError(ParseError::errorExpectedString);
+
+    ++m_current;
+
+    while (true)
+    {
+        bool non_ascii;
+        char const* stop = findStringSpecial<Grammar>(m_current, m_last, &non_ascii);
+
+        if (non_ascii)
+        {
+            char const* invalid = findInvalidUtf8(m_current, stop);
+
+            if (invalid)
+            {
+                m_current = invalid;
+                return setError(ParseError::errorInvalidUtf8);
+            }
+        }
+
+        m_current = stop;
+
+        if (stop == m_last)
+            return setError(ParseError::errorUnexpectedEnd);
+        else if (*stop == '\0')
+            return setError(ParseError::errorUnexpectedNull);
+        else if (not Grammar::allowControlCharacters and static_cast<unsigned char>(*stop) < ' ')
+            return setError(ParseError::errorUnexpectedSymbol);
+
+        if (*stop == '"')
+            break;
+
+        char buf[4];
+
+        if (readEscape<Grammar>(buf) == 0)
+            return false;
+    }
+
+    ++m_current;
+
+    return true;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Grammar>
+bool Scanner::skipNumber()
+{
+    char const* end;
+
+    if (Grammar::allowHexNumbers and startsWith("0x", 2))
+    {
+        Number number;
+        end = Number::parseHex(m_current, m_last, &number);
+    }
+    else
+        end = Number::skip(m_current, m_last);
+
+    if (end == null)
+        return setError(ParseError::errorInvalidNumber);
+
+    m_current = end;
+
+    return true;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool Scanner::readRawNumber(StringView* result, Number::Type* type)
+{
+    char const* end = Number::skip(m_current, m_last, type);
+
+    if (end == null)
+        return setError(ParseError::errorInvalidNumber);
+
+    *result = StringView(m_current, end - m_current);
+    m_current = end;
+
+    return true;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void Scanner::getError(ParseError* error) const
+{
+    char const* position = m_error_position ? m_error_position : m_current;
+
+    error->code = m_error;
+    error->offset = std::min(position, m_last) - m_first;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+char const* Scanner::first() const
+{
+    return m_first;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+char const* Scanner::last() const
+{
+    return m_last;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+char const* Scanner::current() const
+{
+    return m_current;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+Uint Scanner::offset() const
+{
+    return m_current - m_first;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+inline char Scanner::at(Uint ix) const
+{
+    return (ix < Uint(m_last - m_current) ? m_current[ix] : 0);
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Grammar>
+inline void Scanner::skipBlanks()
+{
+    uint64_t const ones = 0x0101010101010101ULL;
+    uint64_t const high = 0x8080808080808080ULL;
+
+    while (m_last - m_current >= 8)
+    {
+        uint64_t word;
+        uint64_t spaces;
+        ::memcpy(&word, m_current, sizeof(word));
+
+        if (Grammar::allowExtraSpaces)
+        {
+            /* a byte is a space when it is ' ' or falls into '\b'..'\r' */
+            uint64_t low = word & ~high;
+            uint64_t in_range = ((low + ones * (0x80 - '\b')) & ~(low + ones * (0x80 - '\r' - 1))) & high;
+            uint64_t not_blank = ((low ^ (ones * ' ')) + ones * 0x7f) & high;
+            spaces = (in_range | (not_blank ^ high)) & ~word & high;
+        }
+        else
+        {
+            spaces = zeroBytes(word ^ (ones * ' ')) | zeroBytes(word ^ (ones * '\t'))
+                     | zeroBytes(word ^ (ones * '\n')) | zeroBytes(word ^ (ones * '\r'));
+        }
+
+        uint64_t others = spaces ^ high;
+
+        if (others)
+        {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+            m_current += __builtin_ctzll(others) / 8;
+#else
+            m_current += __builtin_clzll(others) / 8;
+#endif
+            return;
+        }
+
+        m_current += 8;
+    }
+
+    while (m_current < m_last and isSpace<Grammar>(*m_current))
+        ++m_current;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Grammar>
+bool Scanner::skipSpacesAndComments()
+{
+    while (m_current < m_last)
+    {
+        char c = *m_current;
+
+        if (isSpace<Grammar>(c))
+        {
+            if (m_structural)
+            {
+                Uint position = m_current - m_first;
+
+                while (*m_structural < position)
+                    ++m_structural;
+
+                m_current = m_first + *m_structural;
+            }
+            else
+                skipBlanks<Grammar>();
+        }
+        else if (Grammar::allowComments and c == '/')
+        {
+            if (not skipComment())
+                return false;
+        }
+        else
+            return true;
+    }
+
+    return false;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool Scanner::skipComment()
+{
+    char kind = at(1);
+
+    if (kind != '*' and kind != '/')
+        return setError(ParseError::errorUnexpectedSymbol);
+
+    for (m_current += 2; m_current < m_last; ++m_current)
+    {
+        if (*m_current == '\\')
+        {
+            if (++m_current == m_last)
+                break;
+        }
+        else if (kind == '/' and *m_current == '\n')
+        {
+            ++m_current;
+            return true;
+        }
+        else if (kind == '*' and *m_current == '*' and at(1) == '/')
+        {
+            m_current += 2;
+            return true;
+        }
+    }
+
+    m_current = m_last;
+
+    /* a line comment may end the document */
+    return (kind == '/' ? true : setError(ParseError::errorUnterminatedComment));
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Grammar>
+int Scanner::readEscape(char* result)
+{
+    char c = at(1);
+
+    switch (c)
+    {
+        case '"' :
+        case '\\':
+        case '/' :
+            break;
+        case 'b' :
+            c = '\b';
+            break;
+        case 'f' :
+            c = '\f';
+            break;
+        case 'n' :
+            c = '\n';
+            break;
+        case 'r' :
+            c = '\r';
+            break;
+        case 't' :
+            c = '\t';
+            break;
+        case 'v' :
+            if (not Grammar::allowExtraEscapes)
+                return setError(ParseError::errorInvalidEscape);
+
+            c = '\v';
+            break;
+
+        case 'x' :  /* a single raw byte: \xHH */
+        {
+            if (not Grammar::allowExtraEscapes)
+                return setError(ParseError::errorInvalidEscape);
+
+            int hi = hexValue(at(2));
+            int lo = hexValue(at(3));
+
+            if (hi < 0 or lo < 0)
+                return setError(ParseError::errorInvalidEscape);
+
+            result[0] = char((hi << 4) | lo);
+            m_current += 4;
+            return 1;
+        }
+
+        case 'u' :
+        {
+            unsigned code = 0;
+
+            for (Uint ix = 2; ix < 6; ++ix)
+            {
+                int digit = hexValue(at(ix));
+
+                if (digit < 0)
+                    return setError(ParseError::errorInvalidEscape);
+
+                code = (code << 4) | digit;
+            }
+
+            if (code >= 0xdc00 and code <= 0xdfff)
+                return setError(ParseError::errorInvalidEscape);
+
+            if (code >= 0xd800 and code <= 0xdbff)
+            {
+                unsigned low = 0;
+
+                if (at(6) != '\\' or at(7) != 'u')
+                    return setError(ParseError::errorInvalidEscape);
+
+                for (Uint ix = 8; ix < 12; ++ix)
+                {
+                    int digit = hexValue(at(ix));
+
+                    if (digit < 0)
+                        return setError(ParseError::errorInvalidEscape);
+
+                    low = (low << 4) | digit;
+                }
+
+                if (low < 0xdc00 or low > 0xdfff)
+                    return setError(ParseError::errorInvalidEscape);
+
+                code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+                m_current += 6;
+            }
+
+            m_current += 6;
+            return encodeUtf8(code, result);
+        }
+
+        case '\0':
+            if (m_current + 1 >= m_last)
+            {
+                ++m_current;
+                return setError(ParseError::errorUnexpectedEnd);
+            }
+            return setError(ParseError::errorInvalidEscape);
+
+        default:
+            return setError(ParseError::errorInvalidEscape);
+    }
+
+    result[0] = c;
+    m_current += 2;
+
+    return 1;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void Scanner::appendScratch(char const* str, Uint count)
+{
+    if (m_scratch_length + count + 1 > m_scratch_size)
+    {
+        Uint new_size = std::max(m_scratch_length + count + 1, m_scratch_size * 2);
+        void* mem = ::realloc(m_scratch, new_size);
+        assert(mem != null);
+
+        m_scratch = static_cast<char*>(mem);
+        m_scratch_size = new_size;
+    }
+
+    if (count)
+        ::memcpy(m_scratch + m_scratch_length, str, count);
+
+    m_scratch_length += count;
+    m_scratch[m_scratch_length] = '\0';
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+inline int Scanner::hexValue(char c)
+{
+    if (c >= '0' and c <= '9')
+        return c - '0';
+
+    c |= 0x20;
+
+    if (c >= 'a' and c <= 'f')
+        return c - 'a' + 10;
+
+    return -1;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+inline int Scanner::encodeUtf8(unsigned code, char* result)
+{
+    int length;
+
+    if (code < 0x80)
+    {
+        result[0] = code;
+        length = 1;
+    }
+    else if (code < 0x800)
+    {
+        result[0] = 0xc0 | (code >> 6);
+        result[1] = 0x80 | (code & 0x3f);
+        length = 2;
+    }
+    else if (code < 0x10000)
+    {
+        result[0] = 0xe0 | (code >> 12);
+        result[1] = 0x80 | ((code >> 6) & 0x3f);
+        result[2] = 0x80 | (code & 0x3f);
+        length = 3;
+    }
+    else
+    {
+        result[0] = 0xf0 | (code >> 18);
+        result[1] = 0x80 | ((code >> 12) & 0x3f);
+        result[2] = 0x80 | ((code >> 6) & 0x3f);
+        result[3] = 0x80 | (code & 0x3f);
+        length = 4;
+    }
+
+    return length;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Grammar>
+inline char const* Scanner::findStringSpecial(char const* first, char const* last, bool* non_ascii)
+{
+    unsigned high = 0;
+
+#ifdef __SSE2__
+    __m128i const quote = _mm_set1_epi8('"');
+    __m128i const backslash = _mm_set1_epi8('\\');
+    __m128i const control = _mm_set1_epi8(Grammar::allowControlCharacters ? 0 : ' ' - 1);
+
+    while (last - first >= 16)
+    {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<__m128i const*>(first));
+        __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote),
+                                                     _mm_cmpeq_epi8(chunk, backslash)),
+                                       _mm_cmpeq_epi8(_mm_min_epu8(chunk, control), chunk));
+        unsigned mask = _mm_movemask_epi8(special);
+        unsigned chunk_high = _mm_movemask_epi8(chunk);
+
+        if (mask)
+        {
+            int offset = __builtin_ctz(mask);
+            *non_ascii = (high | (chunk_high & ((1u << offset) - 1))) != 0;
+            return first + offset;
+        }
+
+        high |= chunk_high;
+        first += 16;
+    }
+#endif
+
+    for (; first < last; ++first)
+    {
+        char c = *first;
+
+        if (c == '"' or c == '\\' or c == '\0')
+            break;
+        else if (not Grammar::allowControlCharacters and static_cast<unsigned char>(c) < ' ')
+            break;
+
+        high |= static_cast<unsigned char>(c) & 0x80;
+    }
+
+    *non_ascii = high != 0;
+
+    return first;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template void Scanner::buildIndex<StrictGrammar>();
+template void Scanner::buildIndex<RelaxedGrammar>();
+template bool Scanner::skipSpacesAndComments<StrictGrammar>();
+template bool Scanner::skipSpacesAndComments<RelaxedGrammar>();
+template bool Scanner::readString<StrictGrammar>(StringView* result);
+template bool Scanner::readString<RelaxedGrammar>(StringView* result);
+template bool Scanner::readNumber<StrictGrammar>(Number* result);
+template bool Scanner::readNumber<RelaxedGrammar>(Number* result);
+template bool Scanner::skipString<StrictGrammar>();
+template bool Scanner::skipString<RelaxedGrammar>();
+template bool Scanner::skipNumber<StrictGrammar>();
+template bool Scanner::skipNumber<RelaxedGrammar>();
+
+}  // namespace json
@@ -0,0 +1,329 @@
+/*
+ * jsonutf8.cpp
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "json/jsonutf8.h"
+
+#include <memory.h>
+#include <stdint.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#  include <immintrin.h>
+#  define JSON_UTF8_X86 1
+#endif
+
+namespace json {
+
+#define UTF8_VECTOR_MIN_SIZE 32
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+namespace {
+
+typedef char const* (*FindFunc)(char const* first, char const* last);
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+inline int sequenceLength(unsigned char const* p, unsigned char const* last)
+{
+    int length;
+    unsigned min_second = 0x80;
+    unsigned max_second = 0xbf;
+
+    if (p[0] < 0x80)
+        return 1;
+    else if (p[0] >= 0xc2 and p[0] <= 0xdf)
+        length = 2;
+    else if (p[0] >= 0xe0 and p[0] <= 0xef)
+    {
+        length = 3;
+
+        if (p[0] == 0xe0)
+            min_second = 0xa0;      /* overlong */
+        else if (p[0] == 0xed)
+            max_second = 0x9f;      /* surrogates */
+    }
+    else if (p[0] >= 0xf0 and p[0] <= 0xf4)
+    {
+        length = 4;
+
+        if (p[0] == 0xf0)
+            min_second = 0x90;      /* overlong */
+        else if (p[0] == 0xf4)
+            max_second = 0x8f;      /* above U+10FFFF */
+    }
+    else
+        return 0;
+
+    if (last - p < length or p[1] < min_second or p[1] > max_second)
+        return 0;
+
+    for (int ix = 2; ix < length; ++ix)
+    {
+        if ((p[ix] & 0xc0) != 0x80)
+            return 0;
+    }
+
+    return length;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+char const* findScalar(char const* first, char const* last)
+{
+    unsigned char const* p = reinterpret_cast<unsigned char const*>(first);
+    unsigned char const* end = reinterpret_cast<unsigned char const*>(last);
+
+    while (p < end)
+    {
+        if (*p < 0x80)
+        {
+            ++p;
+            continue;
+        }
+
+        int length = sequenceLength(p, end);
+
+        if (length == 0)
+            return reinterpret_cast<char const*>(p);
+
+        p += length;
+    }
+
+    return null;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*
+ * The vector versions only tell whether a block is valid. The exact byte is
+ * then found by the scalar loop, restarted from the first byte that is not a
+ * continuation among the three before the block: everything before it has
+ * passed, so a sequence cut by the block or by the end starts there.
+ */
+char const* locateError(char const* first, char const* block, char const* last)
+{
+    char const* start = (block - first > 3 ? block - 3 : first);
+
+    while (start < block and (static_cast<unsigned char>(*start) & 0xc0) == 0x80)
+        ++start;
+
+    return findScalar(start, last);
+}
+
+#ifdef JSON_UTF8_X86
+
+/*
+ * Keiser and Lemire, "Validating UTF-8 In Less Than One Instruction Per
+ * Byte". Every pair of adjacent bytes is classified by three table lookups,
+ * on the high and the low nibble of the first byte and the high nibble of
+ * the second; a bit survives their AND only for a forbidden pair. The third
+ * and the fourth bytes of the long sequences are checked by comparing the
+ * bytes two and three positions back.
+ */
+enum
+{
+    tooShort        = 1 << 0,   /* 11______ 0_______ or 11______ 11______ */
+    tooLong         = 1 << 1,   /* 0_______ 10______ */
+    overlong3       = 1 << 2,   /* 11100000 100_____ */
+    tooLarge        = 1 << 3,   /* 11110100 1001____ and above */
+    surrogate       = 1 << 4,   /* 11101101 101_____ */
+    overlong2       = 1 << 5,   /* 1100000_ 10______ */
+    tooLarge1000    = 1 << 6,   /* 11110101 1000____ and above */
+    overlong4       = 1 << 6,   /* 11110000 1000____ */
+    twoConts        = 1 << 7,   /* 10______ 10______ */
+    carry           = tooShort | tooLong | twoConts
+};
+
+#define UTF8_BYTE_1_HIGH \
+    tooLong, tooLong, tooLong, tooLong, tooLong, tooLong, tooLong, tooLong, \
+    char(twoConts), char(twoConts), char(twoConts), char(twoConts), \
+    tooShort | overlong2, \
+    tooShort, \
+    tooShort | overlong3 | surrogate, \
+    tooShort | tooLarge | tooLarge1000 | overlong4
+
+#define UTF8_BYTE_1_LOW \
+    char(carry | overlong3 | overlong2 | overlong4), \
+    char(carry | overlong2), \
+    char(carry), \
+    char(carry), \
+    char(carry | tooLarge), \
+    char(carry | tooLarge | tooLarge1000), \
+    char(carry | tooLarge | tooLarge1000), \
+    char(carry | tooLarge | tooLarge1000), \
+    char(carry | tooLarge | tooLarge1000), \
+    char(carry | tooLarge | tooLarge1000), \
+    char(carry | tooLarge | tooLarge1000), \
+    char(carry | tooLarge | tooLarge1000), \
+    char(carry | tooLarge | tooLarge1000), \
+    char(carry | tooLarge | tooLarge1000 | surrogate), \
+    char(carry | tooLarge | tooLarge1000), \
+    char(carry | tooLarge | tooLarge1000)
+
+#define UTF8_BYTE_2_HIGH \
+    tooShort, tooShort, tooShort, tooShort, tooShort, tooShort, tooShort, tooShort, \
+    char(tooLong | overlong2 | twoConts | overlong3 | tooLarge1000 | overlong4), \
+    char(tooLong | overlong2 | twoConts | overlong3 | tooLarge), \
+    char(tooLong | overlong2 | twoConts | surrogate | tooLarge), \
+    char(tooLong | overlong2 | twoConts | surrogate | tooLarge), \
+    tooShort, tooShort, tooShort, tooShort
+
+__attribute__((target("ssse3")))
+inline __m128i checkBlock16(__m128i input, __m128i previous)
+{
+    __m128i const byte_1_high = _mm_setr_epi8(UTF8_BYTE_1_HIGH);
+    __m128i const byte_1_low = _mm_setr_epi8(UTF8_BYTE_1_LOW);
+    __m128i const byte_2_high = _mm_setr_epi8(UTF8_BYTE_2_HIGH);
+    __m128i const nibble = _mm_set1_epi8(0x0f);
+
+    __m128i prev1 = _mm_alignr_epi8(input, previous, 15);
+    __m128i prev2 = _mm_alignr_epi8(input, previous, 14);
+    __m128i prev3 = _mm_alignr_epi8(input, previous, 13);
+
+    __m128i special = _mm_and_si128(
+            _mm_and_si128(_mm_shuffle_epi8(byte_1_high, _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble)),
+                          _mm_shuffle_epi8(byte_1_low, _mm_and_si128(prev1, nibble))),
+            _mm_shuffle_epi8(byte_2_high, _mm_and_si128(_mm_srli_epi16(input, 4), nibble)));
+
+    __m128i third = _mm_subs_epu8(prev2, _mm_set1_epi8(char(0xe0 - 0x80)));
+    __m128i fourth = _mm_subs_epu8(prev3, _mm_set1_epi8(char(0xf0 - 0x80)));
+    __m128i must_continue = _mm_and_si128(_mm_or_si128(third, fourth), _mm_set1_epi8(char(0x80)));
+
+    return _mm_xor_si128(must_continue, special);
+}
+
+
+__attribute__((target("ssse3")))
+char const* findSsse3(char const* first, char const* last)
+{
+    __m128i const zero = _mm_setzero_si128();
+    __m128i previous = zero;
+    char const* p = first;
+    char tail[16] = { 0 };
+
+    for (; last - p >= 16; p += 16)
+    {
+        __m128i input = _mm_loadu_si128(reinterpret_cast<__m128i const*>(p));
+
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(checkBlock16(input, previous), zero)) != 0xffff)
+            return locateError(first, p, last);
+
+        previous = input;
+    }
+
+    /* The zeros after the tail also catch a sequence cut by the end. */
+    ::memcpy(tail, p, last - p);
+
+    __m128i input = _mm_loadu_si128(reinterpret_cast<__m128i const*>(tail));
+
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(checkBlock16(input, previous), zero)) != 0xffff)
+        return locateError(first, p, last);
+
+    return null;
+}
+
+
+__attribute__((target("avx2")))
+inline __m256i checkBlock32(__m256i input, __m256i previous)
+{
+    __m256i const byte_1_high = _mm256_setr_epi8(UTF8_BYTE_1_HIGH, UTF8_BYTE_1_HIGH);
+    __m256i const byte_1_low = _mm256_setr_epi8(UTF8_BYTE_1_LOW, UTF8_BYTE_1_LOW);
+    __m256i const byte_2_high = _mm256_setr_epi8(UTF8_BYTE_2_HIGH, UTF8_BYTE_2_HIGH);
+    __m256i const nibble = _mm256_set1_epi8(0x0f);
+
+    /* The 16 bytes before each lane: the end of the previous block for the low one. */
+    __m256i shifted = _mm256_permute2x128_si256(previous, input, 0x21);
+    __m256i prev1 = _mm256_alignr_epi8(input, shifted, 15);
+    __m256i prev2 = _mm256_alignr_epi8(input, shifted, 14);
+    __m256i prev3 = _mm256_alignr_epi8(input, shifted, 13);
+
+    __m256i special = _mm256_and_si256(
+            _mm256_and_si256(_mm256_shuffle_epi8(byte_1_high, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble)),
+                             _mm256_shuffle_epi8(byte_1_low, _mm256_and_si256(prev1, nibble))),
+            _mm256_shuffle_epi8(byte_2_high, _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble)));
+
+    __m256i third = _mm256_subs_epu8(prev2, _mm256_set1_epi8(char(0xe0 - 0x80)));
+    __m256i fourth = _mm256_subs_epu8(prev3, _mm256_set1_epi8(char(0xf0 - 0x80)));
+    __m256i must_continue = _mm256_and_si256(_mm256_or_si256(third, fourth), _mm256_set1_epi8(char(0x80)));
+
+    return _mm256_xor_si256(must_continue, special);
+}
+
+
+__attribute__((target("avx2")))
+char const* findAvx2(char const* first, char const* last)
+{
+    __m256i previous = _mm256_setzero_si256();
+    char const* p = first;
+    char tail[32] = { 0 };
+
+    for (; last - p >= 32; p += 32)
+    {
+        __m256i input = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(p));
+
+        if (not _mm256_testz_si256(checkBlock32(input, previous), _mm256_set1_epi8(char(0xff))))
+            return locateError(first, p, last);
+
+        previous = input;
+    }
+
+    ::memcpy(tail, p, last - p);
+
+    __m256i input = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(tail));
+
+    if (not _mm256_testz_si256(checkBlock32(input, previous), _mm256_set1_epi8(char(0xff))))
+        return locateError(first, p, last);
+
+    return null;
+}
+
+#endif /* JSON_UTF8_X86 */
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+FindFunc selectFind()
+{
+#ifdef JSON_UTF8_X86
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2"))
+        return findAvx2;
+    else if (__builtin_cpu_supports("ssse3"))
+        return findSsse3;
+#endif
+
+    return findScalar;
+}
+
+}  // namespace
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+char const* findInvalidUtf8(char const* first, char const* last)
+{
+    static FindFunc const find = selectFind();
+
+    if (last - first < UTF8_VECTOR_MIN_SIZE)
+        return findScalar(first, last);
+
+    return find(first, last);
+}
+
+}  // namespace json
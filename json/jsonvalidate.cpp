@@ -0,0 +1,238 @@
+/*
+ * jsonvalidate.cpp
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "json/jsonvalidate.h"
+#include "json/jsonscanner.h"
+
+#include <stdint.h>
+#include <vector>
+
+namespace json {
+
+namespace {
+
+#define LEVEL_WORDS (JSON_MAX_DEPTH / 64 + 1)
+
+/*
+ * One bit per open container, set for objects. The words past JSON_MAX_DEPTH
+ * are only allocated for a larger depth limit.
+ */
+struct Levels
+{
+    uint64_t                bits[LEVEL_WORDS];
+    std::vector<uint64_t>   more;
+    Uint                    depth = 0;
+
+    uint64_t& word(Uint level)
+    {
+        Uint ix = level / 64;
+        return (ix < LEVEL_WORDS ? bits[ix] : more[ix - LEVEL_WORDS]);
+    }
+
+    void push(bool object)
+    {
+        uint64_t mask = uint64_t(1) << (depth % 64);
+
+        if (depth / 64 >= LEVEL_WORDS + more.size())
+            more.push_back(0);
+
+        uint64_t& current = word(depth);
+
+        current = (object ? current | mask : current & ~mask);
+        ++depth;
+    }
+
+    bool top()
+    {
+        return (word(depth - 1) >> ((depth - 1) % 64)) & 1;
+    }
+};
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Grammar>
+inline bool validateScalar(Scanner& scanner)
+{
+    switch (scanner.peek())
+    {
+        case '"':
+            return scanner.skipString<Grammar>();
+
+        case 't':
+            return scanner.readLiteral("true", 4);
+
+        case 'f':
+            return scanner.readLiteral("false", 5);
+
+        case 'n':
+            return scanner.readLiteral("null", 4);
+
+        case '-':
+        case '0':
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+        case '6':
+        case '7':
+        case '8':
+        case '9':
+            return scanner.skipNumber<Grammar>();
+
+        case '\0':
+            return scanner.setError(ParseError::errorUnexpectedNull);
+
+        default:
+            return scanner.setError(ParseError::errorUnexpectedSymbol);
+    }
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Grammar>
+inline bool validateKey(Scanner& scanner)
+{
+    if (not scanner.skipString<Grammar>())
+        return false;
+
+    if (not scanner.skipSpaces<Grammar>())
+        return scanner.setError(ParseError::errorUnexpectedEnd);
+
+    if (scanner.peek() != ':')
+        return scanner.setError(ParseError::errorExpectedColon);
+
+    scanner.advance();
+
+    return true;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*
+ * The loop of Reader::parseValue() with the handler calls left out.
+ */
+template<typename Grammar>
+bool validateValue(Scanner& scanner, Uint max_depth)
+{
+    Levels levels;
+
+    while (true)
+    {
+        if (not scanner.skipSpaces<Grammar>())
+            return scanner.setError(ParseError::errorUnexpectedEnd);
+
+        char c = scanner.peek();
+
+        if (c == '{' or c == '[')
+        {
+            if (levels.depth >= max_depth)
+                return scanner.setError(ParseError::errorDepthLimit);
+
+            scanner.advance();
+            levels.push(c == '{');
+
+            if (not scanner.skipSpaces<Grammar>())
+                return scanner.setError(ParseError::errorUnexpectedEnd);
+
+            if (scanner.peek() != (c == '{' ? '}' : ']'))
+            {
+                if (c == '{' and not validateKey<Grammar>(scanner))
+                    return false;
+
+                continue;
+            }
+        }
+        else if (not validateScalar<Grammar>(scanner))
+            return false;
+        else if (levels.depth == 0)
+            return true;
+        else if (not scanner.skipSpaces<Grammar>())
+            return scanner.setError(ParseError::errorUnexpectedEnd);
+
+        while (true)
+        {
+            bool object = levels.top();
+            char close = (object ? '}' : ']');
+
+            c = scanner.peek();
+
+            if (c == ',')
+            {
+                scanner.advance();
+
+                if (not scanner.skipSpaces<Grammar>())
+                    return scanner.setError(ParseError::errorUnexpectedEnd);
+
+                if (scanner.peek() != close)
+                {
+                    if (object and not validateKey<Grammar>(scanner))
+                        return false;
+
+                    break;
+                }
+
+                if (not Grammar::allowTrailingCommas)
+                    return scanner.setError(object ? ParseError::errorExpectedString : ParseError::errorUnexpectedSymbol);
+            }
+            else if (c != close)
+                return scanner.setError(ParseError::errorUnexpectedSymbol);
+
+            scanner.advance();
+
+            if (--levels.depth == 0)
+                return true;
+
+            if (not scanner.skipSpaces<Grammar>())
+                return scanner.setError(ParseError::errorUnexpectedEnd);
+        }
+    }
+}
+
+}  // namespace
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Grammar>
+bool validate(char const* first, char const* last, ParseError* error, Uint max_depth)
+{
+    Scanner scanner(first, last);
+
+    if (validateValue<Grammar>(scanner, max_depth))
+    {
+        if (not scanner.skipSpaces<Grammar>() and not scanner.failed())
+            return true;
+
+        scanner.setError(ParseError::errorUnexpectedSymbol);
+    }
+
+    if (error)
+        scanner.getError(error);
+
+    return false;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template bool validate<StrictGrammar>(char const* first, char const* last, ParseError* error, Uint max_depth);
+template bool validate<RelaxedGrammar>(char const* first, char const* last, ParseError* error, Uint max_depth);
+
+}  // namespace json
@@ -25,247 +25,413 @@
  */
 
 #include "json/jsonvalue.h"
+#include "json/jsonarena.h"
+#include "json/jsonkeypool.h"
+#include "json/jsonreader.h"
+#include "json/jsonstream.h"
 
 #include <memory.h>
 #include <sqlite3.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
+#include <memory>
 #include <typeinfo>
+#include <vector>
 
 namespace json {
 
 #define INDENT 2
+
+/*
+ * Longer strings are rarely repeated, so they are not worth hashing.
+ */
+#define INTERN_MAX_LENGTH 128
+
+namespace {
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
-#define return_if_fail(expr, iter, ...) do { \
-        if (not (expr)) \
-        { \
-            char __b[BUFSIZE]; \
-            int len = ::snprintf(__b, BUFSIZE, "%s:%s:%i:'%s', failure. ", __FILE__, __func__, __LINE__, #expr); \
-            ::snprintf(__b + len, BUFSIZE - len, " " __VA_ARGS__); \
-            iter.appendReason(__b); \
-            return; \
-        } } while (0)
+/*
+ * Open-addressing set of the strings already copied into an arena, so that
+ * equal strings of one parse share a single copy.
+ */
+class InternTable
+{
+public:
+    explicit InternTable(Arena* arena);
+
+    char const* intern(char const* str, Uint length);
+
+private:
+    struct Entry
+    {
+        char const* data;
+        Uint        length;
+        Uint        code;
+    };
+
+    void grow();
+
+    static Uint hashCode(char const* str, Uint length);
+
+private:
+    Arena*              m_arena = null;
+    std::vector<Entry>  m_entries;
+    Uint                m_num_items = 0;
+};
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
-#define return_val_if_fail(expr, rval, iter, ...) do { \
-        if (not (expr)) \
-        { \
-            char __b[BUFSIZE]; \
-            int len = ::snprintf(__b, BUFSIZE, "%s:%s:%i:'%s', failure. ", __FILE__, __func__, __LINE__, #expr); \
-            ::snprintf(__b + len, BUFSIZE - len, " " __VA_ARGS__); \
-            iter.appendReason(__b); \
-            return (rval); \
-        } } while (0)
+InternTable::InternTable(Arena* arena) :
+        m_arena(arena),
+        m_entries(64, Entry{null, 0, 0})
+{
+}
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
-inline Value::StateIterator::StateIterator()
+char const* InternTable::intern(char const* str, Uint length)
 {
-    init();
+    if (length > INTERN_MAX_LENGTH)
+        return m_arena->copyString(str, length);
+
+    if ((m_num_items + 1) * 4 > m_entries.size() * 3)
+        grow();
+
+    Uint code = hashCode(str, length);
+    Uint mask = m_entries.size() - 1;
+
+    for (Uint ix = code & mask; ; ix = (ix + 1) & mask)
+    {
+        Entry& entry = m_entries[ix];
+
+        if (entry.data == null)
+        {
+            entry.data = m_arena->copyString(str, length);
+            entry.length = length;
+            entry.code = code;
+            ++m_num_items;
+
+            return entry.data;
+        }
+
+        if (entry.code == code and entry.length == length and ::memcmp(entry.data, str, length) == 0)
+            return entry.data;
+    }
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
-inline Value::StateIterator::StateIterator(char const* first_, char const* last_, char const* cur) :
-        first(first_),
-        last(last_),
-        current(cur ? cur : first_)
+void InternTable::grow()
 {
-    init();
+    std::vector<Entry> entries(m_entries.size() * 2, Entry{null, 0, 0});
+    Uint mask = entries.size() - 1;
+
+    for (Entry const& entry : m_entries)
+    {
+        if (entry.data == null)
+            continue;
+
+        Uint ix = entry.code & mask;
+
+        while (entries[ix].data != null)
+            ix = (ix + 1) & mask;
+
+        entries[ix] = entry;
+    }
+
+    m_entries.swap(entries);
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
-inline Value::StateIterator::StateIterator(StateIterator const& other)
+Uint InternTable::hashCode(char const* str, Uint length)
 {
-    init();
-    assign(other);
+    // FNV-1a
+    Uint code = 2166136261u;
+
+    for (Uint ix = 0; ix < length; ++ix)
+        code = (code ^ static_cast<unsigned char>(str[ix])) * 16777619u;
+
+    return code;
 }
+
+}  // namespace
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
-inline Value::StateIterator::~StateIterator()
+/*
+ * Reader handler that builds the tree: every value is parsed straight into
+ * its slot in the parent container.
+ */
+struct Value::Builder
 {
-    this->unref();
-    this->first = this->last = this->current = null;
-}
+    Builder(Value* root_, bool borrow_, Arena* arena_, InternTable* strings_, KeyPool* keys_);
+
+    bool onNull();
+    bool onBool(bool value);
+    bool onInteger(Integer value);
+    bool onDouble(double value);
+    bool onRawNumber(StringView text, Number::Type type);
+    bool onString(StringView value);
+    bool onKey(StringView key);
+    bool onStartObject();
+    bool onEndObject();
+    bool onStartArray();
+    bool onEndArray();
+
+    Value* emplace(Type type);
+
+    Value*              root = null;
+    Value*              key_slot = null;
+    bool                borrow = false;
+    Arena*              arena = null;
+    InternTable*        strings = null;
+    KeyPool*            keys = null;
+    std::vector<Value*> stack;
+    std::string         key;
+};
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
-inline Value::StateIterator& Value::StateIterator::operator=(char const* other)
+inline Value::Builder::Builder(Value* root_, bool borrow_, Arena* arena_, InternTable* strings_, KeyPool* keys_) :
+        root(root_),
+        borrow(borrow_),
+        arena(arena_),
+        strings(strings_),
+        keys(keys_)
 {
-    this->current = other;
-    return *this;
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
-inline Value::StateIterator& Value::StateIterator::operator+=(int nth)
+inline Value* Value::Builder::emplace(Type type)
 {
-    this->increase(nth);
-    return *this;
+    Value* value = key_slot;
+
+    if (stack.empty())
+        value = root;
+    else if (stack.back()->type() == Type::typeArray)
+    {
+        Array& array = stack.back()->array();
+
+        if (arena and array.numItems() == array.reserved())
+            array.reserve((array.reserved() * 3) / 2 + 1, arena);
+
+        value = &array[array.numItems()];
+    }
+
+    if (value->isUsed())
+        value->clear();
+
+    return ::new(value) Value(type, arena);
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
-inline void Value::StateIterator::appendReason(char const* reason)
+inline bool Value::Builder::onNull()
 {
-    if (this->rf == null)
-        this->ref();
-
-    void* mem = ::realloc(this->rf, sizeof(*this->rf) * (this->num_reasons + 3));
-    this->rf = static_cast<int*>(mem);
-    this->reasons = static_cast<char**>(static_cast<void*>(this->rf + 1));
-    this->reasons[this->num_reasons] = reason ? ::strdup(reason) : null;
-    this->num_reasons += 1;
-    this->reasons[this->num_reasons] = null;
+    emplace(Type::typeNull);
+    return true;
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
-inline Value::StateIterator::operator bool() const
+inline bool Value::Builder::onBool(bool value)
 {
-    return (this->current and *this->current and this->current < this->last);
+    emplace(Type::typeBoolean)->as<bool>() = value;
+    return true;
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
-inline bool Value::StateIterator::operator!() const
+inline bool Value::Builder::onInteger(Integer value)
 {
-    bool result = (*this);
-    return (not result);
+    emplace(Type::typeInteger)->as<Integer>() = value;
+    return true;
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
-inline char Value::StateIterator::operator*() const
+inline bool Value::Builder::onDouble(double value)
 {
-    return (this->current ? *this->current : 0);
+    emplace(Type::typeDouble)->as<double>() = value;
+    return true;
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
-inline Value::StateIterator& Value::StateIterator::operator++()
+inline bool Value::Builder::onRawNumber(StringView text, Number::Type type)
 {
-    this->increase(1);
-    return *this;
+    Value* value = emplace(type == Number::typeInteger ? Type::typeInteger : Type::typeDouble);
+
+    value->m_flags |= flagRawNumber;
+
+    if (text.length <= holder_size or borrow)
+        value->setText(text.data, text.length, true);
+    else if (arena)
+        value->setText(arena->copyString(text.data, text.length), text.length, true);
+    else
+        value->setText(text.data, text.length, false);
+
+    return true;
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
-inline void Value::StateIterator::increase(int count)
+inline bool Value::Builder::onString(StringView value)
 {
-    if (this->current >= this->last or *this->current == 0 or count == 0)
-        return;
+    Value* str = emplace(Type::typeString);
 
-    do {
-        unsigned uc = *this->current;
+    if (value.length <= holder_size or borrow)
+        str->setText(value.data, value.length, true);
+    else if (strings)
+        str->setText(strings->intern(value.data, value.length), value.length, true);
+    else if (arena)
+        str->setText(arena->copyString(value.data, value.length), value.length, true);
+    else
+        str->setText(value.data, value.length, false);
 
-        if      ((uc & 0xfc) == 0xfc)
-            this->current += 6;
-        else if ((uc & 0xf8) == 0xf8)
-            this->current += 5;
-        else if ((uc & 0xf0) == 0xf0)
-            this->current += 4;
-        else if ((uc & 0xe0) == 0xe0)
-            this->current += 3;
-        else if ((uc & 0xc0) == 0xc0)
-            this->current += 2;
-        else if ((uc & 0x80) == 0x80)
-            while (this->current < this->last and (*this->current & 0x80) == 0x80)
-                ++this->current;
-        else
-            ++this->current;
-    } while (--count > 0 and this->current < this->last and *this->current != 0);
+    return true;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+inline bool Value::Builder::onKey(StringView value)
+{
+    Map& map = stack.back()->map();
 
-    return;
+    if (keys)
+        key_slot = &map.insertBorrowed(keys->intern(value.data, value.length), arena);
+    else if (borrow)
+        key_slot = &map.insertBorrowed(value.data, arena);
+    else if (arena)
+        key_slot = &map.insertBorrowed(arena->copyString(value.data, value.length), arena);
+    else
+    {
+        key.assign(value.data, value.length);
+        key_slot = &map[key.c_str()];
+    }
+
+    return true;
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
-inline char Value::StateIterator::operator[](int ix)
+inline bool Value::Builder::onStartObject()
 {
-    return this->current[ix];
+    stack.push_back(emplace(Type::typeMap));
+    return true;
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
-inline int Value::StateIterator::index() const
+inline bool Value::Builder::onEndObject()
 {
-    return this->current - this->first;
+    stack.pop_back();
+    return true;
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
-inline void Value::StateIterator::assign(StateIterator const& other)
+inline bool Value::Builder::onStartArray()
 {
-    this->unref();
-    this->first = other.first;
-    this->last = other.last;
-    this->current = other.current;
-    this->reasons = other.reasons;
-    this->rf = other.rf;
-    this->num_reasons = other.num_reasons;
-    this->ref();
+    stack.push_back(emplace(Type::typeArray));
+    return true;
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
-inline int Value::StateIterator::ref()
+inline bool Value::Builder::onEndArray()
 {
-    if (this->rf)
-    {
-        ++(*this->rf);
-        return *this->rf;
-    }
+    stack.pop_back();
+    return true;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+static_assert(sizeof(Value) == 16, "Value is expected to take 16 bytes");
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename vT, typename ...Args>
+inline void Value::constructOutOfLine(Arena* arena, Args&&... args)
+{
+    void* mem = (arena ? arena->allocate(sizeof(vT)) : ::malloc(sizeof(vT)));
+
+    assert(mem != null);
 
-    return 0;
+    as<vT*>() = ::new(mem) vT(std::forward<Args>(args)...);
+
+    if (arena)
+        m_flags |= flagExternal;
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
-inline int Value::StateIterator::unref()
+template<typename vT>
+inline void Value::destructOutOfLine()
 {
-    if (this->rf)
+    vT* object = as<vT*>();
+
+    object->~vT();
+
+    if (not (m_flags & flagExternal))
+        ::free(object);
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+inline char const* Value::text() const
+{
+    if (m_length <= holder_size)
+        return reinterpret_cast<char const*>(&m_data);
+
+    return as<char*>();
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+inline bool Value::ownsText() const
+{
+    return (m_length > holder_size and not (m_flags & flagBorrowed));
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*
+ * Texts of fresh values only: a short one is copied into the payload, a long
+ * borrowed one is taken as it is and anything else is copied to the heap.
+ */
+inline void Value::setText(char const* str, Uint length, bool borrowed)
+{
+    m_length = length;
+
+    if (length <= holder_size)
+        ::memcpy(&m_data, str, length);
+    else if (borrowed)
     {
-        --(*this->rf);
-        if (*this->rf <= 0)
-        {
-            for (Uint i = 0; i < this->num_reasons; ++i)
-            {
-                ::free(this->reasons[i]);
-                this->reasons[i] = null;
-            }
+        as<char const*>() = str;
+        m_flags |= flagBorrowed;
+    }
+    else
+    {
+        char* data = static_cast<char*>(::malloc(length + 1));
 
-            ::free(this->rf);
-            this->num_reasons = 0;
-            this->reasons = null;
-            return 0;
-        }
+        assert(data != null);
 
-        return *this->rf;
+        ::memcpy(data, str, length);
+        data[length] = '\0';
+        as<char*>() = data;
     }
-    return 0;
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
-inline void Value::StateIterator::init()
+Value::Value(Type tp) :
+        Value(tp, null)
 {
-    void* mem = ::malloc(sizeof(int));
-    this->rf = static_cast<int*>(mem);
-    *this->rf = 1;
-    this->reasons = static_cast<char**>(static_cast<void*>(this->rf + 1));
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
-Value::Value(Type tp) :
+Value::Value(Type tp, Arena* arena) :
         m_type(tp)
 {
     switch (tp)
     {
         case Type::typeBoolean:
-            construct<bool>(false);
+            as<bool>() = false;
             break;
         case Type::typeInteger:
-            construct<Integer>(0);
+            as<Integer>() = 0;
             break;
         case Type::typeDouble:
-            construct<double>(0.0);
-            break;
-        case Type::typeString:
-            construct<std::string>();
+            as<double>() = 0.0;
             break;
         case Type::typeArray:
-            construct<Array>();
+            constructOutOfLine<Array>(arena, 0, arena);
             break;
         case Type::typeMap:
-            construct<Map>();
+            constructOutOfLine<Map>(arena, 0, arena);
             break;
         default:
             break;
@@ -276,105 +442,105 @@ Value::Value(Type tp) :
 Value::Value(bool value) :
         m_type(Type::typeBoolean)
 {
-    construct<bool>(value);
+    as<bool>() = value;
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
 Value::Value(int value) :
         m_type(Type::typeInteger)
 {
-    construct<Integer>(value);
+    as<Integer>() = value;
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
 Value::Value(long int value) :
         m_type(Type::typeInteger)
 {
-    construct<Integer>(value);
+    as<Integer>() = value;
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
 Value::Value(long long int value) :
         m_type(Type::typeInteger)
 {
-    construct<Integer>(value);
+    as<Integer>() = value;
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
 Value::Value(unsigned int value) :
         m_type(Type::typeInteger)
 {
-    construct<Integer>(value);
+    as<Integer>() = value;
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
 Value::Value(unsigned long int value) :
         m_type(Type::typeInteger)
 {
-    construct<Integer>(value);
+    as<Integer>() = value;
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
 Value::Value(unsigned long long int value) :
         m_type(Type::typeInteger)
 {
-    construct<Integer>(value);
+    as<Integer>() = value;
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
 Value::Value(char const* value) :
         m_type(Type::typeString)
 {
-    construct<std::string>(value ? value : "");
+    setText(value, value ? ::strlen(value) : 0, false);
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
 Value::Value(std::string const& value) :
         m_type(Type::typeString)
 {
-    construct<std::string>(value);
+    setText(value.data(), value.size(), false);
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
 Value::Value(float value) :
         m_type(Type::typeDouble)
 {
-    construct<double>(value);
+    as<double>() = value;
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
 Value::Value(double value) :
         m_type(Type::typeDouble)
 {
-    construct<double>(value);
+    as<double>() = value;
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
 Value::Value(Array const& value) :
         m_type(Type::typeArray)
 {
-    construct<Array>(value);
+    constructOutOfLine<Array>(null, value);
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
 Value::Value(std::initializer_list<Value> const& list) :
         m_type(Type::typeArray)
 {
-    construct<Array>(list);
+    constructOutOfLine<Array>(null, list);
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
 Value::Value(Map const& value) :
         m_type(Type::typeMap)
 {
-    construct<Map>(value);
+    constructOutOfLine<Map>(null, value);
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
 Value::Value(std::initializer_list<std::pair<char const*, Value>> const& list) :
         m_type(Type::typeMap)
 {
-    construct<Map>(list);
+    constructOutOfLine<Map>(null, list);
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
@@ -382,29 +548,27 @@ Value::~Value()
 {
     switch (type())
     {
-        case Type::typeBoolean:
-            destruct<bool>();
-            break;
         case Type::typeInteger:
-            destruct<Integer>();
-            break;
         case Type::typeDouble:
-            destruct<double>();
+            if ((m_flags & flagRawNumber) and ownsText())
+                ::free(as<char*>());
             break;
         case Type::typeString:
-            destruct<std::string>();
+            if (ownsText())
+                ::free(as<char*>());
             break;
         case Type::typeArray:
-            destruct<Array>();
+            destructOutOfLine<Array>();
             break;
         case Type::typeMap:
-            destruct<Map>();
+            destructOutOfLine<Map>();
             break;
         default:
             break;
     }
 
     m_type = Type::untyped;
+    m_flags = 0;
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
@@ -434,13 +598,13 @@ Value& Value::operator=(Value&& other)
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
-inline Value::Type Value::type() const
+Value::Type Value::type() const
 {
     return m_type;
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
-inline bool Value::empty() const
+bool Value::empty() const
 {
     return type() == Type::untyped;
 }
@@ -499,9 +663,9 @@ Uint Value::size() const
     switch (type())
     {
         case Type::typeArray:
-            return as<Array>().numItems();
+            return array().numItems();
         case Type::typeMap:
-            return as<Map>().numItems();
+            return map().numItems();
         default:
             return 0;
     }
@@ -513,7 +677,7 @@ bool Value::hasKey(char const* key) const
     switch (type())
     {
         case Type::typeMap:
-            return as<Map>().hasKey(key);
+            return map().hasKey(key);
         default:
             return false;
     }
@@ -526,6 +690,18 @@ bool Value::hasKey(std::string const& key) const
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
+bool Value::hasKey(Key const& key) const
+{
+    switch (type())
+    {
+        case Type::typeMap:
+            return map().hasKey(key);
+        default:
+            return false;
+    }
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
 Value::operator bool() const
 {
     return asBoolean();
@@ -611,11 +787,11 @@ bool Value::asBoolean() const
         case Type::typeBoolean:
             return as<bool>();
         case Type::typeInteger:
-            return as<Integer>();
+            return ((m_flags & flagRawNumber) ? rawNumber().integer : as<Integer>());
         case Type::typeDouble:
-            return as<double>();
+            return ((m_flags & flagRawNumber) ? rawNumber().real : as<double>());
         case Type::typeString:
-            return (as<std::string>().size() > 0);
+            return (m_length > 0);
         case Type::typeMap:
         case Type::typeArray:
             return (size() > 0);
@@ -633,11 +809,11 @@ Integer Value::asInteger() const
         case Type::typeBoolean:
             return (as<bool>() ? 1 : 0);
         case Type::typeInteger:
-            return as<Integer>();
+            return ((m_flags & flagRawNumber) ? rawNumber().integer : as<Integer>());
         case Type::typeDouble:
-            return as<double>();
+            return ((m_flags & flagRawNumber) ? rawNumber().real : as<double>());
         case Type::typeString:
-            return as<std::string>().size();
+            return m_length;
         case Type::typeMap:
         case Type::typeArray:
             return this->size();
@@ -655,9 +831,9 @@ double  Value::asDouble() const
         case Type::typeBoolean:
             return as<bool>() ? 1.0 : 0.0;
         case Type::typeInteger:
-            return as<Integer>();
+            return ((m_flags & flagRawNumber) ? rawNumber().integer : as<Integer>());
         case Type::typeDouble:
-            return as<double>();
+            return ((m_flags & flagRawNumber) ? rawNumber().real : as<double>());
         default:
             return 0.0;
     }
@@ -697,7 +873,7 @@ Array Value::asArray() const
     switch (type())
     {
         case Type::typeArray:
-            return as<Array>();
+            return array();
         default:
             return Array();
     }
@@ -709,7 +885,7 @@ Map Value::asMap() const
     switch (type())
     {
         case Type::typeMap:
-            return as<Map>();
+            return map();
         default:
             return Map();
     }
@@ -721,7 +897,7 @@ void Value::insert(char const* key, Value const& value)
     if (not isMap())
         return;
 
-    as<Map>().insert(key, value);
+    map().insert(key, value);
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
@@ -730,7 +906,7 @@ void Value::insert(std::string const& key, Value const& value)
     if (not isMap())
         return;
 
-    as<Map>().insert(key, value);
+    map().insert(key, value);
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
@@ -739,7 +915,7 @@ void Value::insert(Uint ix, Value const& value)
     if (not isArray())
         return;
 
-    as<Array>().insert(ix, value);
+    array().insert(ix, value);
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
@@ -748,7 +924,7 @@ void Value::remove(char const* key)
     if (not isMap())
         return;
 
-    as<Map>().remove(key);
+    map().remove(key);
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
@@ -757,7 +933,7 @@ void Value::remove(std::string const& key)
     if (not isMap())
         return;
 
-    as<Map>().remove(key.c_str());
+    map().remove(key.c_str());
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
@@ -766,15 +942,15 @@ void Value::remove(Uint ix)
     if (not isArray())
         return;
 
-    as<Array>().remove(ix);
+    array().remove(ix);
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
 bool Value::get(char const* key, Value& result)
 {
-    if (isMap() and as<Map>().hasKey(key))
+    if (isMap() and map().hasKey(key))
     {
-        result = as<Map>()[key];
+        result = map()[key];
         return true;
     }
 
@@ -784,9 +960,9 @@ bool Value::get(char const* key, Value& result)
 //------------------------------------------------------------------------------
 bool Value::get(std::string const& key, Value& result)
 {
-    if (isMap() and as<Map>().hasKey(key.c_str()))
+    if (isMap() and map().hasKey(key.c_str()))
     {
-        result = as<Map>()[key];
+        result = map()[key];
         return true;
     }
 
@@ -798,7 +974,7 @@ bool Value::get(Uint ix, Value& result)
 {
     if (isArray() and ix < size())
     {
-        result = as<Array>()[ix];
+        result = array()[ix];
         return true;
     }
     return false;
@@ -810,9 +986,9 @@ Value& Value::operator[](char const* key)
     switch (type())
     {
         case Type::typeMap:
-            return as<Map>()[key];
+            return map()[key];
         case Type::typeArray:
-            return *as<Array>().end();
+            return *array().end();
         default:
             throw std::bad_cast();
     }
@@ -825,14 +1001,28 @@ Value& Value::operator[](std::string const& key)
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
+Value& Value::operator[](Key const& key)
+{
+    switch (type())
+    {
+        case Type::typeMap:
+            return map()[key];
+        case Type::typeArray:
+            return *array().end();
+        default:
+            throw std::bad_cast();
+    }
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
 Value& Value::operator[](int ix)
 {
     switch (type())
     {
         case Type::typeMap:
-            return *as<Map>().end();
+            return *map().end();
         case Type::typeArray:
-            return as<Array>()[ix];
+            return array()[ix];
         default:
             throw std::bad_cast();
     }
@@ -844,9 +1034,9 @@ Value const& Value::operator[](char const* key) const
     switch (type())
     {
         case Type::typeMap:
-            return as<Map>()[key];
+            return map()[key];
         case Type::typeArray:
-            return *as<Array>().end();
+            return *array().end();
         default:
             throw std::bad_cast();
     }
@@ -859,14 +1049,28 @@ Value const& Value::operator[](std::string const& key) const
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
+Value const& Value::operator[](Key const& key) const
+{
+    switch (type())
+    {
+        case Type::typeMap:
+            return map()[key];
+        case Type::typeArray:
+            return *array().end();
+        default:
+            throw std::bad_cast();
+    }
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
 Value const& Value::operator[](int ix) const
 {
     switch (type())
     {
         case Type::typeMap:
-            return *as<Map>().end();
+            return *map().end();
         case Type::typeArray:
-            return as<Array>()[ix];
+            return array()[ix];
         default:
             throw std::bad_cast();
     }
@@ -878,7 +1082,7 @@ char const* Value::getKey(const_iterator iter) const
     switch (type())
     {
         case Type::typeMap:
-            return as<Map>().getKey(iter);
+            return map().getKey(iter);
         default:
             return null;
     }
@@ -892,19 +1096,25 @@ void Value::assign(Value const& other)
     switch (other.type())
     {
         case Type::typeMap:
-            dummy.as<Map>().assign(other.as<Map>());
+            dummy.map().assign(other.map());
             break;
 
         case Type::typeArray:
-            dummy.as<Array>().assign(other.as<Array>());
+            dummy.array().assign(other.array());
             break;
 
         case Type::typeString:
-            dummy.as<std::string>().assign(other.as<std::string>());
+            dummy.setText(other.text(), other.m_length, false);
             break;
 
         default:
-            dummy.m_data = other.m_data;
+            if (other.m_flags & flagRawNumber)
+            {
+                dummy.m_flags = flagRawNumber;
+                dummy.setText(other.text(), other.m_length, false);
+            }
+            else
+                dummy.m_data = other.m_data;
     }
 
     swap(dummy);
@@ -915,6 +1125,8 @@ void Value::swap(Value& other)
 {
     std::swap(m_data, other.m_data);
     std::swap(m_type, other.m_type);
+    std::swap(m_length, other.m_length);
+    std::swap(m_flags, other.m_flags);
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
@@ -930,9 +1142,9 @@ json::iterator Value::begin()
     switch (type())
     {
         case Type::typeArray:
-            return as<Array>().begin();
+            return array().begin();
         case Type::typeMap:
-            return as<Map>().begin();
+            return map().begin();
         default:
             return this;
     }
@@ -944,9 +1156,9 @@ json::iterator Value::end()
     switch (type())
     {
         case Type::typeArray:
-            return as<Array>().end();
+            return array().end();
         case Type::typeMap:
-            return as<Map>().end();
+            return map().end();
         default:
             return this;
     }
@@ -958,9 +1170,9 @@ json::const_iterator Value::begin() const
     switch (type())
     {
         case Type::typeArray:
-            return as<Array>().begin();
+            return array().begin();
         case Type::typeMap:
-            return as<Map>().begin();
+            return map().begin();
         default:
             return this;
     }
@@ -972,9 +1184,9 @@ json::const_iterator Value::end() const
     switch (type())
     {
         case Type::typeArray:
-            return as<Array>().end();
+            return array().end();
         case Type::typeMap:
-            return as<Map>().end();
+            return map().end();
         default:
             return this;
     }
@@ -983,63 +1195,46 @@ json::const_iterator Value::end() const
 //------------------------------------------------------------------------------
 Uint Value::distance(const_iterator first, const_iterator last)
 {
-    int result = 0;
-
-    while (first < last)
-    {
-        result += first->isUsed();
-        ++first;
-    }
-
-    return result;
+    return (first < last ? last - first : 0);
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
 Uint Value::distance(iterator first, iterator last)
 {
-    int result = 0;
-
-    while (first < last)
-    {
-        result += first->isUsed();
-        ++first;
-    }
-
-    return result;
+    return (first < last ? last - first : 0);
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
-bool Value::parseStream(FILE* fd)
+bool Value::parseStream(FILE* fd, ParseError* error)
 {
     check_and_return_val(fd != null, false);
 
-    int const block_size = 1024;
-    int ret_value = 0;
-    char block[block_size];
-    char *result_data = null;
-    Uint length = 0;
-    bool result = false;
+    Uint const block_size = 64 * 1024;
+    std::vector<char> block(block_size);
+    Value val;
+    Builder builder(&val, false, null, null, null);
+    StreamReader<Builder> reader(builder);
+    Uint count = 0;
 
     do {
-        ret_value = ::fread(block, sizeof(char), block_size, fd);
-        result_data = appendData(result_data, length, block, ret_value);
-    } while (ret_value == block_size and result_data);
+        count = ::fread(block.data(), sizeof(char), block_size, fd);
+    } while (reader.feed(block.data(), count) and count == block_size);
 
-    check_and_return_val(result_data != null, false);
+    if (not reader.finish(error))
+        return false;
 
-    result = parseData(result_data, result_data + length);
-    ::free(result_data);
+    swap(val);
 
-    return result;
+    return true;
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
-bool Value::parseFile(const char* filename)
+bool Value::parseFile(const char* filename, ParseError* error)
 {
     check_and_return_val(filename != null and *filename != '\0', false);
 
     FILE* fd = ::fopen(filename, "rb");
-    bool result = parseStream(fd);
+    bool result = parseStream(fd, error);
 
     if (fd)
         ::fclose(fd);
@@ -1048,66 +1243,73 @@ bool Value::parseFile(const char* filename)
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
-bool Value::parseFile(std::string const& filename)
+bool Value::parseFile(std::string const& filename, ParseError* error)
+{
+    return parseFile(filename.c_str(), error);
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool Value::parseData(char const* first, char const* last, ParseError* error, bool raw_numbers)
 {
-    return parseFile(filename.c_str());
+    return parseData<RelaxedGrammar>(first, last, error, raw_numbers);
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
-bool Value::parseData(char const* first, char const* last)
+bool Value::parseDataInSitu(char* first, char* last, ParseError* error, bool raw_numbers)
+{
+    return parseDataInSitu<RelaxedGrammar>(first, last, error, raw_numbers);
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Grammar>
+bool Value::parseData(char const* first, char const* last, ParseError* error, bool raw_numbers)
+{
+    return parseInternal<Grammar>(first, last, false, null, false, null, error, raw_numbers);
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Grammar>
+bool Value::parseDataInSitu(char* first, char* last, ParseError* error, bool raw_numbers)
+{
+    return parseInternal<Grammar>(first, last, true, null, false, null, error, raw_numbers);
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Grammar>
+bool Value::parseInternal(char const* first, char const* last, bool in_situ, Arena* arena, bool intern_strings, KeyPool* keys, ParseError* error, bool raw_numbers)
 {
     Value val;
-    StateIterator iter(first, last);
+    std::unique_ptr<InternTable> strings;
 
-    if (val.parseValue(iter))
-    {
-        (*this) = val;
-        return true;
-    }
-    else
-    {
-        char** it = iter.reasons;
+    if (arena and intern_strings and not in_situ)
+        strings.reset(new InternTable(arena));
 
-        while (*it)
-        {
-            printf("%s\n", *it);
-            ++it;
-        }
+    Builder builder(&val, in_situ, arena, strings.get(), keys);
+    Reader<Builder, Grammar> reader(builder);
 
-        int const block_size = 40;
-        char block[block_size + 1];
-        char const* start = iter.current;
-        char const* end = std::min(start + block_size, iter.last);
-        ::memcpy(block, start, sizeof(char) * (end - start));
-        block[end - start] = 0;
-        char* p = block;
+    reader.setRawNumbers(raw_numbers);
 
-        while (*p)
-        {
-            switch (*p)
-            {
-                case '\n':
-                case '\r':
-                case '\v':
-                case '\t':
-                    *p = ' ';
-                    break;
-                default:
-                    break;
-            }
-            ++p;
-        }
+    if (in_situ ? not reader.parseInSitu(const_cast<char*>(first), const_cast<char*>(last), error)
+                : not reader.parse(first, last, error))
+        return false;
 
-        ::fprintf(::stderr, "Syntax error at position %u:\n'%s'\n", iter.index(), block);
-    }
+    swap(val);
 
-    return false;
+    return true;
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
-bool Value::parseString(std::string const& data)
+template bool Value::parseData<StrictGrammar>(char const* first, char const* last, ParseError* error, bool raw_numbers);
+template bool Value::parseData<RelaxedGrammar>(char const* first, char const* last, ParseError* error, bool raw_numbers);
+template bool Value::parseDataInSitu<StrictGrammar>(char* first, char* last, ParseError* error, bool raw_numbers);
+template bool Value::parseDataInSitu<RelaxedGrammar>(char* first, char* last, ParseError* error, bool raw_numbers);
+template bool Value::parseInternal<StrictGrammar>(char const* first, char const* last, bool in_situ, Arena* arena, bool intern_strings, KeyPool* keys, ParseError* error, bool raw_numbers);
+template bool Value::parseInternal<RelaxedGrammar>(char const* first, char const* last, bool in_situ, Arena* arena, bool intern_strings, KeyPool* keys, ParseError* error, bool raw_numbers);
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool Value::parseString(std::string const& data, ParseError* error, bool raw_numbers)
 {
-    return parseData(data.c_str(), data.c_str() + data.size());
+    return parseData(data.c_str(), data.c_str() + data.size(), error, raw_numbers);
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
@@ -1117,7 +1319,7 @@ bool Value::saveToStream(FILE* fd, bool pretty_print) const
 
     std::string result;
 
-    check_and_return_val(dumpInternal(&result, pretty_print, false, 0), false);
+    check_and_return_val(dumpInternal(&result, pretty_print, true, 0), false);
     check_and_return_val(result.size() > 0, false);
 
     int retval = ::fwrite(result.data(), sizeof(char), result.size(), fd);
@@ -1150,7 +1352,7 @@ bool Value::saveToFile(std::string const& filename, bool pretty_print) const
 //------------------------------------------------------------------------------
 bool Value::saveToString(std::string* result, bool pretty_print) const
 {
-    return dumpInternal(result, pretty_print, false, 0);
+    return dumpInternal(result, pretty_print, true, 0);
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
@@ -1174,437 +1376,68 @@ char* Value::saveToData(int& length, bool pretty_print) const
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
-char* Value::appendData(char* data, Uint& length, char const* block, Uint count)
+Number Value::rawNumber() const
 {
-    if (count == 0)
-        return data;
+    Number number;
 
-    void* mem = ::realloc(data, sizeof(*data) * (length + count + 1));
+    Number::parse(text(), text() + m_length, &number);
 
-    check_and_return_val(mem != null, data, "%i:%s", errno, ::strerror(errno));
-
-    data = static_cast<char*>(mem);
-    ::memcpy(data + length, block, sizeof(*data) * count);
-    length += count;
-    data[length] = 0;
-    return data;
+    return number;
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
-inline bool Value::skipMultilineComment(StateIterator& iter)
+void Value::appendEscaped(std::string* result, char const* str, Uint length)
 {
-    if (*iter != '/' or iter[1] != '*')
-        return true;
+    static char const hex[] = "0123456789abcdef";
+    char const* run = str;
+    char const* last = str + length;
 
-    iter += 2;
+    result->reserve(result->size() + length);
 
-    while (iter)
+    for (char const* p = str; p < last; ++p)
     {
-        if (*iter == '\\')
-            ++iter;
-
-        if (iter and *iter == '*' and iter[1] == '/')
-        {
-            iter += 2;
-            return (bool) iter;
-        }
+        unsigned char c = *p;
+        char buf[6] = { '\\', 0, '0', '0', 0, 0 };
+        Uint count = 2;
 
-        ++iter;
-    }
-
-    return_val_if_fail(iter, false, iter, "Unexpected end of the comment block");
-
-    return false;
-}
-//------------------------------------------------------------------------------
-//------------------------------------------------------------------------------
-inline bool Value::skipSinglelineComment(StateIterator& iter)
-{
-    if (not iter)
-        return false;
-    else if (iter[0] != '/' or iter[1] != '/')
-        return true;
-
-    iter += 2;
-
-    while (iter)
-    {
-        if (*iter == '\\')
-            ++iter;
-
-        if (iter and *iter == '\n')
-        {
-            ++iter;
-            return (bool) iter;
-        }
-
-        ++iter;
-    }
-
-    return_val_if_fail(iter, false, iter, "Unexpected end of the comment line");
-
-    return true;
-}
-//------------------------------------------------------------------------------
-//------------------------------------------------------------------------------
-inline bool Value::skipCommentsAndSpaces(StateIterator& iter)
-{
-    while ((bool) iter)
-    {
-        switch (*iter)
+        switch (c)
         {
-            case '\n' :
-            case '\r' :
-            case ' ' :
-            case '\t' :
-            case '\v' :
-            case '\f' :
-            case '\b' :
-                ++iter;
-                break;
+            case '"' :
+            case '\\':
             case '/' :
-                return_val_if_fail(iter[1] == '/' or iter[1] == '*', false, iter, "Unexpected symbol");
-
-                if (iter[1] == '*')
-                    return_val_if_fail(skipMultilineComment(iter), false, iter);
-                else if (iter[1] == '/')
-                    return_val_if_fail(skipSinglelineComment(iter), false, iter);
+                buf[1] = c;
                 break;
-
-            default:
-                return (bool) iter;
-        }
-    };
-
-    return false;
-}
-//------------------------------------------------------------------------------
-//------------------------------------------------------------------------------
-inline bool Value::parseString(StateIterator& iter, std::string& result)
-{
-    return_val_if_fail(skipCommentsAndSpaces(iter), false, iter);
-    return_val_if_fail(*iter == '"', false, iter, "Expected '\"', but got '%c'", *iter);
-
-    ++iter;
-
-    while ((bool) iter)
-    {
-        return_val_if_fail(*iter != '\0', false, iter, "Unexpected end of data");
-
-        switch (*iter)     /* switch 1 */
-        {
-            case '"' :
-                ++iter;
-                return (bool) iter;
-            default:
-                result.insert(result.end(), *iter);
-                ++iter;
+            case '\b':
+                buf[1] = 'b';
                 break;
-
-            case '\\' :
-            {
-                ++iter;
-
-                switch (*iter) /* switch 2 */
-                {
-                    case 'u': // utf-16 and utf-32
-                    {
-                        char* end;
-                        ++iter;
-                        return_val_if_fail(iter, false, iter);
-
-                        unsigned uc = std::strtoul(iter.current, &end, 16);
-
-                        return_val_if_fail(uc <= 0x10ffff and end != null, false, iter, "Failed to parse hex string");
-
-                        if (uc < 0x80)
-                        {
-                            result.append(1, uc);
-                        }
-                        else if (uc <= 0x07ff)
-                        {
-                            result.append(1, (0xc0 | ((uc >> 6) & 0x1f)));
-                            result.append(1, (0x80 | ((uc >> 0) & 0x3f)));
-                        }
-                        else if (uc <= 0xffff)
-                        {
-                            result.append(1, (0xe0 | ((uc >> 12) & 0x0f)));
-                            result.append(1, (0x80 | ((uc >>  6) & 0x3f)));
-                            result.append(1, (0x80 | ((uc >>  0) & 0x3f)));
-                        }
-                        else
-                        {
-                            result.append(1, (0xf0 | ((uc >> 18) & 0x07)));
-                            result.append(1, (0x80 | ((uc >> 12) & 0x3f)));
-                            result.append(1, (0x80 | ((uc >>  6) & 0x3f)));
-                            result.append(1, (0x80 | ((uc >>  0) & 0x3f)));
-                        }
-
-                        iter = end;
-
-                        break;
-                    }   /* end of case 'u' */
-
-                    case 'x': // utf-8
-                    {
-                        char *end = null;
-                        ++iter;
-                        return_val_if_fail(iter, false, iter);
-
-                        unsigned uc = std::strtoul(iter.current, &end, 16);
-
-                        return_val_if_fail(end != null, false, iter, "Failed to parse hex string");
-
-                        result.insert(result.end(), uc);
-                        iter = end;
-                        break;
-                    }
-
-                    case '"' :
-                    case '/' :
-                        result.insert(result.end(), *iter);
-                        ++iter;
-                        break;
-
-                    case 't':
-                    case 'f':
-                    case 'n':
-                    case 'v':
-                    case 'r':
-                    case 'b':
-                    case '\\':
-                    default:
-                        result.insert(result.end(), '\\');
-                        result.insert(result.end(), *iter);
-                        ++iter;
-                }   /* end of switch 2 */
+            case '\f':
+                buf[1] = 'f';
                 break;
-            }   /* end of case '\\' */
-        }   /* end of switch 1 */
-
-    }   /* end of while */
-
-    return_val_if_fail((bool) iter, false, iter, "Unexpected end of data");
-    return_val_if_fail(*iter == '"', false, iter, "Unexpexted end of string. Expected '\"', but got '%c'", *iter);
-
-    ++iter;
-
-    return (bool) iter;
-}
-//------------------------------------------------------------------------------
-//------------------------------------------------------------------------------
-inline bool Value::strIsDouble(StateIterator iter)
-{
-    if (not skipCommentsAndSpaces(iter))
-        return false;
-
-    while (iter)
-    {
-        switch (*iter)
-        {
-            case '0':
-            case '1':
-            case '2':
-            case '3':
-            case '4':
-            case '5':
-            case '6':
-            case '7':
-            case '8':
-            case '9':
-            case '-':
-            case '+':
+            case '\n':
+                buf[1] = 'n';
+                break;
+            case '\r':
+                buf[1] = 'r';
+                break;
+            case '\t':
+                buf[1] = 't';
                 break;
-            case 'e':
-            case '.':
-                return true;
             default:
-                return false;
-        }
-
-        ++iter;
-    }
-
-    return false;
-}
-//------------------------------------------------------------------------------
-//------------------------------------------------------------------------------
-inline bool Value::parseArray(StateIterator& iter)
-{
-    return_val_if_fail(*iter == '[', false, iter, "Unexpected begin symbol for array");
-
-    ++iter;
-
-    while (iter and *iter != ']')
-    {
-        Value val;
-        return_val_if_fail(val.parseValue(iter), false, iter);
-        (*this)[size()] = val;
-
-        if (*iter == ',')
-            ++iter;
-
-        return_val_if_fail(skipCommentsAndSpaces(iter), false, iter);
-    }
-
-    return_val_if_fail(iter and *iter == ']', false, iter, "Unexpected final symbol for array.");
-    ++iter;
-
-    return true;
-}
-//------------------------------------------------------------------------------
-//------------------------------------------------------------------------------
-inline bool Value::parseMap(StateIterator& iter)
-{
-    return_val_if_fail(iter and *iter == '{', false, iter, "Unexpected begin symbol for object");
-
-    ++iter;
-
-    while (iter and *iter != '}')
-    {
-        Value val;
-        std::string key;
-
-        return_val_if_fail(parseString(iter, key), false, iter);
-        return_val_if_fail(skipCommentsAndSpaces(iter), false, iter);
-        return_val_if_fail(*iter == ':', false, iter, "Unbound symbol. Expected ':', but got '%c'", *iter);
-        return_val_if_fail((bool) (++iter), false, iter);
-        return_val_if_fail(val.parseValue(iter), false, iter);
-
-        (*this)[key] = val;
-
-        if (*iter == ',')
-            ++iter;
-
-        return_val_if_fail(skipCommentsAndSpaces(iter), false, iter);
-    }
-
-    return_val_if_fail(iter, false, iter, "Unexpected end of data");
-    return_val_if_fail(*iter == '}', false, iter, "Unexpected final symbol for object.");
+                if (c >= 0x20)
+                    continue;
 
-    ++iter;
-
-    return true;
-}
-//------------------------------------------------------------------------------
-//------------------------------------------------------------------------------
-inline bool Value::parseValue(StateIterator& iter)
-{
-    while (iter)
-    {
-        return_val_if_fail(skipCommentsAndSpaces(iter), false, iter);
-
-        switch (*iter)
-        {
-            case '{':
-                (*this) = Value(Value::Type::typeMap);
-                return parseMap(iter);
-
-            case '[':
-                (*this) = Value(Value::Type::typeArray);
-                return parseArray(iter);
-
-            case '"':
-                (*this) = std::string();
-                return parseString(iter, as<std::string>());
-
-            case 't':
-            {
-                return_val_if_fail(::strncmp(iter.current, "true", 4) == 0, false, iter, "Unknown symbol 't'");
-                (*this) = true;
-                iter += 4;
-                return (bool) iter;
-            }
-
-            case 'f':
-            {
-                return_val_if_fail(::strncmp(iter.current, "false", 5) == 0, false, iter, "Unknown symbol 'f'");
-                (*this) = false;
-                iter += 5;
-                return (bool) iter;
-            }
-
-            case '-':
-            case '0':
-            case '1':
-            case '2':
-            case '3':
-            case '4':
-            case '5':
-            case '6':
-            case '7':
-            case '8':
-            case '9':
-            {
-                char* end;
-
-                if (::strncmp(iter.current, "0x", 2) == 0)
-                    (*this) = ::strtoll(iter.current, &end, 16);
-                else if (strIsDouble(iter))
-                    (*this) = ::strtod(iter.current, &end);
-                else
-                    (*this) = ::strtoll(iter.current, &end, 10);
-
-                return_val_if_fail(end != null, false, iter);
-                iter = end;
-
-                return (bool) iter;
-            }
-
-            case 'n':
-            {
-                return_val_if_fail(::strncmp(iter.current, "null", 4) == 0, false, iter, "Unknown symbol 'n'");
-                (*this) = Value(Value::Type::typeNull);
-                iter += 4;
-                return (bool) iter;
-            }
-
-            case ',':
-            default:
-                ++iter;
-                break;
+                buf[1] = 'u';
+                buf[4] = hex[c >> 4];
+                buf[5] = hex[c & 0xf];
+                count = 6;
         }
 
+        result->append(run, p - run);
+        result->append(buf, count);
+        run = p + 1;
     }
 
-    return false;
-}
-//------------------------------------------------------------------------------
-//------------------------------------------------------------------------------
-inline void Value::dumpStringAsRaw(std::string* result) const
-{
-    std::string const& str = as<std::string>();
-
-    result->reserve(result->size() + str.size());
-
-    for (char c : str)
-    {
-        switch (c)
-        {
-            case '/'  :
-                result->insert(result->end(), '\\');
-                result->insert(result->end(), '/');
-                break;
-
-            case '\\' :
-                result->insert(result->end(), '\\');
-                result->insert(result->end(), '\\');
-                break;
-
-            case '"' :
-                result->insert(result->end(), '\\');
-                result->insert(result->end(), '"');
-                break;
-
-            case '\t' :
-            case '\r' :
-            case '\v' :
-            case '\f' :
-            case '\b' :
-            default:
-                result->insert(result->end(), c);
-        }
-    }
+    result->append(run, last - run);
 }
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
@@ -1675,13 +1508,13 @@ inline void Value::dumpMap(std::string* result, bool pretty_print, bool as_raw,
 
     result->append("{");
 
-    while (it < end)
+    for (; it < end; ++it)
     {
         std::string str;
-        char const* key;
 
-        if (it->dumpInternal(&str, pretty_print, as_raw, indent + 1) and (key = as<Map>().getKey(it)))
+        if (it->dumpInternal(&str, pretty_print, as_raw, indent + 1))
         {
+            char const* key = map().getKey(it);
             char const* quotes = (it->isString() ? "\"" : "");
 
             if (has_prev)
@@ -1691,15 +1524,18 @@ inline void Value::dumpMap(std::string* result, bool pretty_print, bool as_raw,
 
             result->append(spaces);
             result->append("\"");
-            result->append(key);
+
+            if (as_raw)
+                appendEscaped(result, key, ::strlen(key));
+            else
+                result->append(key);
+
             result->append("\": ");
             result->append(quotes);
             result->append(str);
             result->append(quotes);
             has_prev = true;
         }
-
-        ++it;
     }
 
     if (has_prev and pretty_print)
@@ -1728,29 +1564,40 @@ bool Value::dumpInternal(std::string* result, bool pretty_print, bool as_raw, in
             result->assign(asBoolean() ? "true" : "false");
             break;
         case Type::typeInteger:
-            result->assign(std::to_string(asInteger()));
+            if (m_flags & flagRawNumber)
+                result->assign(text(), m_length);
+            else
+                result->assign(std::to_string(as<Integer>()));
             break;
         case Type::typeDouble:
         {
-            char buf[BUFSIZE];
-            ::snprintf(buf, BUFSIZE, "%f", asDouble());
-            result->assign(buf[0] ? buf : "0.0");
+            if (m_flags & flagRawNumber)
+            {
+                result->assign(text(), m_length);
+                break;
+            }
+
+            char buf[Number::formatSize];
+            Uint length = Number::format(as<double>(), buf);
+            Number::Type type;
+
+            result->assign(buf, length);
+
+            // Keep 1.0 a double when it is read back
+            if (Number::skip(buf, buf + length, &type) == buf + length and type == Number::typeInteger)
+                result->append(".0");
+
             break;
         }
 
         case Type::typeString:
-        {
             if (not as_raw)
-                result->assign(as<std::string>().c_str());
+                result->assign(text(), m_length);
             else
-            {
-                std::string data;
-                dumpStringAsRaw(&data);
-                result->append(data);
-            }
+                appendEscaped(result, text(), m_length);
 
             break;
-        }
+
         case Type::typeArray:
             dumpArray(result, pretty_print, as_raw, indent);
             break;
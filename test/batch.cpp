@@ -0,0 +1,165 @@
+/*
+ * batch.cpp
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <string>
+#include <vector>
+
+#include <json/json.h>
+#include <json/jsonbatch.h>
+
+#include "check.h"
+
+using namespace json;
+
+namespace {
+
+std::vector<std::string> documents(std::string const& text, BatchParser::Format format)
+{
+    std::vector<StringView> views;
+    std::vector<std::string> result;
+
+    BatchParser::findDocuments(text.data(), text.data() + text.size(), format, &views);
+
+    for (StringView const& view : views)
+        result.push_back(std::string(view.data, view.length));
+
+    return result;
+}
+
+} // namespace
+
+int main()
+{
+    // Lines, with blank ones in between.
+    std::vector<std::string> lines = documents("{\"a\": 1}\n\n  \n[2]\r\n3", BatchParser::formatLines);
+    CHECK(lines.size() == 3);
+    CHECK(lines.size() == 3 and lines[0] == "{\"a\": 1}" and lines[1] == "[2]\r" and lines[2] == "3");
+
+    // Concatenated documents, separated by spaces or RS, with brackets hidden
+    // in strings and comments.
+    std::vector<std::string> docs = documents("{\"a\": \"}\"}[1, /* ] */ 2]\x1e{\"b\": \"\\\"{\"}  \"s\" 4",
+                                              BatchParser::formatConcatenated);
+    CHECK(docs.size() == 5);
+    CHECK(docs.size() == 5 and docs[0] == "{\"a\": \"}\"}" and docs[1] == "[1, /* ] */ 2]" and
+          docs[2] == "{\"b\": \"\\\"{\"}" and docs[3] == "\"s\"" and docs[4] == "4");
+
+    // The results come back in input order on any number of threads.
+    std::string data;
+
+    for (int ix = 0; ix < 1000; ++ix)
+        data += "{\"n\": " + std::to_string(ix) + ", \"s\": \"" + std::to_string(ix * 3) + "\"}\n";
+
+    for (Uint threads = 1; threads <= 4; ++threads)
+    {
+        BatchParser parser(threads, 16);
+        std::vector<Value> result;
+
+        CHECK(parser.numThreads() == threads);
+        CHECK(parser.parse(data.data(), data.data() + data.size(), &result));
+        CHECK(result.size() == 1000);
+
+        for (Uint ix = 0; ix < result.size(); ++ix)
+        {
+            if (result[ix]["n"].asInteger() != Integer(ix) or result[ix]["s"].asString() != std::to_string(ix * 3))
+            {
+                CHECK(not "out of order");
+                break;
+            }
+        }
+    }
+
+    BatchParser concatenated(2, 4);
+    std::vector<Value> values;
+    std::string stream = "{\"a\": 1}{\"a\": 2}\x1e{\"a\": 3} [4]";
+
+    concatenated.setFormat(BatchParser::formatConcatenated);
+    CHECK(concatenated.format() == BatchParser::formatConcatenated);
+    CHECK(concatenated.parse(stream.data(), stream.data() + stream.size(), &values));
+    CHECK(values.size() == 4);
+    CHECK(values.size() == 4 and values[2]["a"].asInteger() == 3 and values[3][0].asInteger() == 4);
+
+    // The error policies.
+    std::string broken = "[1]\n[2]\n[3 x]\n[4]\n{\n";
+    BatchParser parser(2, 1);
+    ParseError error;
+
+    CHECK(parser.errorPolicy() == BatchParser::policyStop);
+    CHECK(not parser.parse(broken.data(), broken.data() + broken.size(), &values, &error));
+    CHECK(error.code == ParseError::errorUnexpectedSymbol);
+    CHECK(error.offset == 11);
+    CHECK(values.size() == 2);
+
+    parser.setErrorPolicy(BatchParser::policySkip);
+    CHECK(parser.parse(broken.data(), broken.data() + broken.size(), &values, &error));
+    CHECK(error.offset == 11);
+    CHECK(parser.numFailed() == 2);
+    CHECK(values.size() == 3);
+    CHECK(values.size() == 3 and values[2][0].asInteger() == 4);
+
+    parser.setErrorPolicy(BatchParser::policyKeepEmpty);
+    CHECK(parser.parse(broken.data(), broken.data() + broken.size(), &values, &error));
+    CHECK(parser.numFailed() == 2);
+    CHECK(values.size() == 5);
+    CHECK(values.size() == 5 and not values[2].isUsed() and not values[4].isUsed() and values[3][0].asInteger() == 4);
+
+    // One parser serves many calls with the same workers.
+    BatchParser reused(4, 8);
+
+    data.clear();
+
+    for (int ix = 0; ix < 1000; ++ix)
+        data += "{\"n\": " + std::to_string(ix) + "}\n";
+
+    for (int round = 0; round < 50; ++round)
+    {
+        CHECK(reused.parse(data.data(), data.data() + data.size(), &values));
+        CHECK(values.size() == 1000);
+        CHECK(values.size() == 1000 and values[999]["n"].asInteger() == 999);
+    }
+
+    // The error points into the whole buffer, first failure in input order.
+    std::string bad_data = data;
+    size_t bad = bad_data.find("{\"n\": 500}");
+
+    bad_data[bad + 6] = 'x';
+    CHECK(not reused.parse(bad_data.data(), bad_data.data() + bad_data.size(), &values, &error));
+    CHECK(error.code == ParseError::errorInvalidLiteral or error.code == ParseError::errorUnexpectedSymbol);
+    CHECK(error.offset == bad + 6);
+    CHECK(values.size() == 500);
+
+    reused.setErrorPolicy(BatchParser::policySkip);
+    CHECK(reused.parse(bad_data.data(), bad_data.data() + bad_data.size(), &values, &error));
+    CHECK(error.offset == bad + 6);
+    CHECK(reused.numFailed() == 1);
+    CHECK(values.size() == 999);
+
+    // Fewer documents than one batch run on the calling thread alone.
+    CHECK(reused.parse(data.data(), data.data() + 20, &values));
+    CHECK(values.size() == 2);
+
+    return CHECK_RESULT();
+}
@@ -0,0 +1,219 @@
+/*
+ * bind.cpp
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <math.h>
+#include <stdint.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <json/json.h>
+#include <json/jsonbind.h>
+
+#include "check.h"
+
+namespace app {
+
+struct Point
+{
+    int x = 0;
+    int y = 0;
+};
+
+JSON_BIND(Point, x, y)
+
+struct Shape
+{
+    std::string                 name;
+    bool                        closed = false;
+    double                      area = 0.0;
+    int64_t                     id = 0;
+    std::vector<Point>          points;
+    std::map<std::string, int>  tags;
+};
+
+JSON_BIND(Shape, name, closed, area, id, points, tags)
+
+struct Tree
+{
+    int                 value = 0;
+    std::vector<Tree>   children;
+};
+
+JSON_BIND(Tree, value, children)
+
+struct Counters
+{
+    uint64_t    total;
+    uint32_t    small;
+    int64_t     delta;
+    json::Value extra;
+};
+
+JSON_BIND(Counters, total, small, delta, extra)
+
+} // namespace app
+
+using namespace json;
+
+namespace {
+
+template<typename T>
+bool readsAs(std::string const& data, T expected)
+{
+    T value = T();
+
+    return parseString(data, &value) and value == expected;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename T>
+ParseError::Code errorOf(std::string const& data)
+{
+    T value = T();
+    ParseError error;
+
+    parseString(data, &value, &error);
+
+    return error.code;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename T>
+std::string write(T const& object)
+{
+    std::string text;
+    saveToString(object, &text);
+    return text;
+}
+
+} // namespace
+
+int main()
+{
+    // Members in any order, unknown ones skipped, missing ones left alone.
+    app::Shape shape;
+    std::string text = "{\"points\": [{\"y\": 2, \"x\": 1}, {\"x\": 3, \"y\": 4, \"z\": [5, {\"w\": null}]}], "
+            "\"unknown\": {\"a\": [1, 2, \"three\"]}, \"name\": \"tri\\u0061ngle\", \"closed\": true, "
+            "\"tags\": {\"red\": 1, \"big\": 2}, \"id\": -9000000000}";
+
+    CHECK(parseString(text, &shape));
+    CHECK(shape.name == "triangle");
+    CHECK(shape.closed);
+    CHECK(shape.area == 0.0);
+    CHECK(shape.id == -9000000000LL);
+    CHECK(shape.points.size() == 2);
+    CHECK(shape.points.size() == 2 and shape.points[0].x == 1 and shape.points[0].y == 2 and shape.points[1].y == 4);
+    CHECK(shape.tags.size() == 2 and shape.tags["red"] == 1 and shape.tags["big"] == 2);
+
+    // Values of the wrong type, or integers that do not fit, are refused.
+    CHECK(errorOf<app::Point>("{\"x\": \"1\"}") == ParseError::errorTypeMismatch);
+    CHECK(errorOf<app::Point>("{\"x\": 1.5}") == ParseError::errorTypeMismatch);
+    CHECK(errorOf<app::Point>("{\"x\": 2147483648}") == ParseError::errorTypeMismatch);
+    CHECK(errorOf<app::Point>("[1, 2]") == ParseError::errorTypeMismatch);
+    CHECK(errorOf<app::Shape>("{\"closed\": 1}") == ParseError::errorTypeMismatch);
+    CHECK(errorOf<app::Shape>("{\"points\": {}}") == ParseError::errorTypeMismatch);
+    CHECK(errorOf<std::vector<int>>("[1, null]") == ParseError::errorTypeMismatch);
+    CHECK(errorOf<int>("-2147483649") == ParseError::errorTypeMismatch);
+    CHECK(errorOf<unsigned char>("256") == ParseError::errorTypeMismatch);
+
+    // Skipped members are still validated, and the grammar is the reader's.
+    CHECK(errorOf<app::Point>("{\"q\": [1, tru], \"x\": 1}") == ParseError::errorInvalidLiteral);
+    CHECK(errorOf<app::Point>("{\"x\": 1 \"y\": 2}") == ParseError::errorUnexpectedSymbol);
+
+    app::Point point;
+    std::string commented = "{\"x\": 1, /* c */ \"y\": 2,}";
+    CHECK(parseString(commented, &point) and point.y == 2);
+    CHECK(not parseString<StrictGrammar>(commented, &point));
+
+    // Recursive structs stop at the depth limit.
+    std::string deep;
+
+    for (int ix = 0; ix < JSON_MAX_DEPTH; ++ix)
+        deep += "{\"children\": [";
+
+    for (int ix = 0; ix < JSON_MAX_DEPTH; ++ix)
+        deep += "]}";
+
+    CHECK(errorOf<app::Tree>(deep) == ParseError::errorDepthLimit);
+
+    app::Tree tree;
+    CHECK(parseString("{\"value\": 1, \"children\": [{\"value\": 2, \"children\": []}, {\"value\": 3}]}", &tree));
+    CHECK(tree.children.size() == 2 and tree.children[1].value == 3);
+
+    // Writing is compact, doubles are the shortest text that reads back.
+    app::Shape written;
+    written.name = "a \"quoted\"\nname";
+    written.area = 0.1;
+    written.id = 42;
+    written.points.resize(1);
+    written.points[0].x = -1;
+    written.tags["k"] = 7;
+
+    CHECK(write(written) == "{\"name\":\"a \\\"quoted\\\"\\nname\",\"closed\":false,\"area\":0.1,\"id\":42,"
+          "\"points\":[{\"x\":-1,\"y\":0}],\"tags\":{\"k\":7}}");
+
+    app::Shape again;
+    CHECK(parseString(write(written), &again));
+    CHECK(write(again) == write(written));
+
+    CHECK(write(std::vector<double>{1.0 / 3.0, 1e300, -0.5, INFINITY, NAN}) == "[0.3333333333333333,1e+300,-0.5,null,null]");
+
+    // Unsigned values past the range of a signed 64-bit integer.
+    CHECK(readsAs<uint64_t>("18446744073709551615", UINT64_MAX));
+    CHECK(readsAs<uint64_t>("9223372036854775808", 9223372036854775808ULL));
+    CHECK(readsAs<uint64_t>("9223372036854775807", 9223372036854775807ULL));
+    CHECK(errorOf<uint64_t>("18446744073709551616") == ParseError::errorTypeMismatch);
+    CHECK(errorOf<uint64_t>("-1") == ParseError::errorTypeMismatch);
+    CHECK(errorOf<uint64_t>("1.5") == ParseError::errorTypeMismatch);
+    CHECK(errorOf<uint64_t>("1e19") == ParseError::errorTypeMismatch);
+    CHECK(errorOf<uint32_t>("4294967296") == ParseError::errorTypeMismatch);
+    CHECK(errorOf<int64_t>("9223372036854775808") == ParseError::errorTypeMismatch);
+
+    app::Counters counters = { UINT64_MAX, 7, -5, Value() };
+    app::Counters copy = { 0, 0, 0, Value() };
+
+    text.clear();
+    counters.extra.parseString("{\"a\": [1, 2.5, \"x\"], \"b\": {}}");
+    saveToString(counters, &text);
+
+    // Value members are written as compactly as the rest.
+    CHECK(text == "{\"total\":18446744073709551615,\"small\":7,\"delta\":-5,\"extra\":{\"a\":[1,2.5,\"x\"],\"b\":{}}}");
+    CHECK(parseString(text, &copy));
+    CHECK(copy.total == UINT64_MAX and copy.small == 7 and copy.delta == -5);
+    CHECK(copy.extra["a"][2].asString() == "x");
+
+    std::vector<Value> values(2);
+
+    values[0].parseString("[\"\", null, true]");
+    text.clear();
+    saveToString(values, &text);
+    CHECK(text == "[[\"\",null,true],null]");
+
+    return CHECK_RESULT();
+}
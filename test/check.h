@@ -0,0 +1,47 @@
+/*
+ * check.h
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef _JSON_TEST_CHECK_H_
+#define _JSON_TEST_CHECK_H_
+
+#include <stdio.h>
+
+/*
+ * Every test is a program that runs its checks and fails if any of them did.
+ */
+static int check_failures = 0;
+
+#define CHECK(expr) { \
+    if (not (expr)) \
+    { \
+        fprintf(::stderr, "%s:%i: check failed: %s\n", __FILE__, __LINE__, #expr); \
+        ++check_failures; \
+    } }
+
+#define CHECK_RESULT() (check_failures == 0 ? 0 : 1)
+
+#endif /* _JSON_TEST_CHECK_H_ */
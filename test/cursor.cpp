@@ -0,0 +1,92 @@
+/*
+ * cursor.cpp
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <string>
+
+#include <json/jsonvalue.h>
+
+#include "check.h"
+
+using namespace json;
+
+namespace {
+
+std::string dump(char const* first, char const* last)
+{
+    Value value;
+    std::string result;
+
+    if (value.parseData(first, last))
+        value.saveToString(&result);
+
+    return result;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+std::string dump(std::string const& text)
+{
+    return dump(text.data(), text.data() + text.size());
+}
+
+} // namespace
+
+int main()
+{
+    // A top-level scalar may end exactly at the end of the data.
+    CHECK(dump("123") == "123");
+    CHECK(dump("-7") == "-7");
+    CHECK(dump("true") == "true");
+    CHECK(dump("false") == "false");
+    CHECK(dump("null") == "null");
+
+    // Only [first, last) is read, even when the buffer goes on behind it.
+    char const* text = "[true][false]";
+    CHECK(dump(text, text + 6) == "[true]");
+    CHECK(dump(text + 1, text + 5) == "true");
+    CHECK(dump(text + 7, text + 12) == "false");
+
+    // Runs of whitespace of every length and alignment around the tokens.
+    char const spaces[] = " \t\r\n";
+
+    for (Uint length = 0; length < 40; ++length)
+    {
+        for (Uint shift = 0; shift < 8; ++shift)
+        {
+            std::string run;
+
+            for (Uint ix = 0; ix < length; ++ix)
+                run += spaces[(ix + shift) % 4];
+
+            std::string input = std::string(shift, ' ') + "[" + run + "1" + run + "," + run + "{" + run +
+                    "\"k\"" + run + ":" + run + "null" + run + "}" + run + "]" + run;
+
+            CHECK(dump(input) == "[1, {\"k\": null}]");
+        }
+    }
+
+    return CHECK_RESULT();
+}
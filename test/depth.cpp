@@ -0,0 +1,154 @@
+/*
+ * depth.cpp
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <string>
+
+#include <json/json.h>
+#include <json/jsonreader.h>
+#include <json/jsonstream.h>
+
+#include "check.h"
+
+using namespace json;
+
+namespace {
+
+/*
+ * Counts the containers and remembers the deepest level reached.
+ */
+struct DepthHandler
+{
+    Uint depth = 0;
+    Uint deepest = 0;
+    Uint containers = 0;
+
+    bool open() { ++containers; if (++depth > deepest) deepest = depth; return true; }
+    bool close() { --depth; return true; }
+
+    bool onNull() { return true; }
+    bool onBool(bool) { return true; }
+    bool onInteger(Integer) { return true; }
+    bool onDouble(double) { return true; }
+    bool onString(StringView) { return true; }
+    bool onKey(StringView) { return true; }
+    bool onStartObject() { return open(); }
+    bool onEndObject() { return close(); }
+    bool onStartArray() { return open(); }
+    bool onEndArray() { return close(); }
+};
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+std::string nested(Uint depth)
+{
+    return std::string(depth, '[') + std::string(depth, ']');
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+std::string nestedObjects(Uint depth)
+{
+    std::string text;
+
+    for (Uint ix = 0; ix < depth; ++ix)
+        text += ix % 2 ? "[" : "{\"a\": ";
+
+    text += "1";
+
+    for (Uint ix = depth; ix > 0; --ix)
+        text += (ix - 1) % 2 ? "]" : "}";
+
+    return text;
+}
+
+} // namespace
+
+int main()
+{
+    Value value;
+    ParseError error;
+
+    // The default limit is JSON_MAX_DEPTH levels, objects and arrays alike.
+    CHECK(value.parseString(nested(JSON_MAX_DEPTH)));
+    CHECK(not value.parseString(nested(JSON_MAX_DEPTH + 1), &error));
+    CHECK(error.code == ParseError::errorDepthLimit);
+    CHECK(error.offset == JSON_MAX_DEPTH);
+    CHECK(value.parseString(nestedObjects(JSON_MAX_DEPTH)));
+    CHECK(not value.parseString(nestedObjects(JSON_MAX_DEPTH + 1), &error));
+    CHECK(error.code == ParseError::errorDepthLimit);
+
+    // A million brackets are refused instead of overflowing the stack.
+    std::string deep = nested(1000000);
+    CHECK(not value.parseString(deep, &error));
+    CHECK(error.code == ParseError::errorDepthLimit);
+    CHECK(error.offset == JSON_MAX_DEPTH);
+
+    // With the limit raised they parse in constant native stack.
+    DepthHandler handler;
+    Reader<DepthHandler> reader(handler);
+
+    CHECK(reader.maxDepth() == JSON_MAX_DEPTH);
+    reader.setMaxDepth(1000000);
+    CHECK(reader.parse(deep.data(), deep.data() + deep.size()));
+    CHECK(handler.deepest == 1000000);
+    CHECK(handler.containers == 1000000);
+    CHECK(handler.depth == 0);
+
+    std::string three = "[[[1]], {\"a\": [2]}]";
+    std::string four = "[[[[1]]]]";
+
+    reader.setMaxDepth(3);
+    CHECK(reader.parse(three.data(), three.data() + three.size()));
+    CHECK(not reader.parse(four.data(), four.data() + four.size(), &error));
+    CHECK(error.code == ParseError::errorDepthLimit and error.offset == 3);
+
+    // The stream reader stops at the same place.
+    for (Uint limit : {Uint(1), Uint(5), Uint(JSON_MAX_DEPTH)})
+    {
+        std::string text = nestedObjects(limit + 1);
+        DepthHandler stream_handler;
+        StreamReader<DepthHandler> stream(stream_handler);
+        Reader<DepthHandler> limited(handler);
+        ParseError stream_error;
+
+        stream.setMaxDepth(limit);
+        limited.setMaxDepth(limit);
+        CHECK(stream.maxDepth() == limit);
+        CHECK(not limited.parse(text.data(), text.data() + text.size(), &error));
+
+        for (Uint ix = 0; ix < text.size(); ix += 3)
+        {
+            if (not stream.feed(text.data() + ix, std::min(Uint(3), Uint(text.size()) - ix)))
+                break;
+        }
+
+        CHECK(not stream.finish(&stream_error));
+        CHECK(stream_error.code == ParseError::errorDepthLimit);
+        CHECK(stream_error.code == error.code);
+        CHECK(stream_error.offset == error.offset);
+    }
+
+    return CHECK_RESULT();
+}
@@ -0,0 +1,248 @@
+/*
+ * document.cpp
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include <json/json.h>
+#include <json/jsonarena.h>
+#include <json/jsondocument.h>
+
+#include "check.h"
+
+using namespace json;
+
+namespace {
+
+/*
+ * An array of objects with keys and strings of every length, so that the
+ * arena has to add blocks and hand out large pieces of its own.
+ */
+std::string makeText(int count)
+{
+    std::string text = "[";
+
+    for (int i = 0; i < count; ++i)
+    {
+        std::string word(i % 40, char('a' + i % 26));
+
+        if (i > 0)
+            text += ", ";
+
+        text += "{\"id\": " + std::to_string(i) + ", \"name\": \"" + word + "\", \"" + word + "key\": [" +
+                std::to_string(i * 0.25) + ", true, null, \"esc\\n" + word + "\"]}";
+    }
+
+    return text + "]";
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+std::string save(Value const& value)
+{
+    std::string result;
+
+    value.saveToString(&result);
+    return result;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+std::string expected(std::string const& text)
+{
+    Value value;
+
+    CHECK(value.parseString(text));
+    return save(value);
+}
+
+} // namespace
+
+int main()
+{
+    // The arena hands out aligned memory from blocks that grow.
+    {
+        Arena arena(1024);
+        std::vector<char*> pieces;
+
+        CHECK(arena.used() == 0);
+
+        for (size_t size = 1; size < 5000; size += 37)
+        {
+            char* piece = static_cast<char*>(arena.allocate(size));
+
+            CHECK(reinterpret_cast<uintptr_t>(piece) % Arena::alignment == 0);
+            memset(piece, int(size), size);
+            pieces.push_back(piece);
+        }
+
+        for (size_t i = 0, size = 1; size < 5000; size += 37, ++i)
+            CHECK(pieces[i][0] == char(size) and pieces[i][size - 1] == char(size));
+
+        CHECK(arena.used() >= 5000 * 135 / 2);
+
+        char* copy = arena.copyString("hello", 5);
+
+        CHECK(strcmp(copy, "hello") == 0);
+
+        arena.release();
+        CHECK(arena.used() == 0);
+        CHECK(arena.allocate(16) != null);
+    }
+
+    // An arena over a buffer of the caller uses it first and the heap after.
+    {
+        char buffer[1000];
+        Arena arena(buffer, sizeof(buffer));
+        char* first = static_cast<char*>(arena.allocate(100));
+
+        CHECK(first >= buffer and first + 100 <= buffer + sizeof(buffer));
+
+        char* outside = static_cast<char*>(arena.allocate(2000));
+
+        CHECK(outside + 2000 <= buffer or outside >= buffer + sizeof(buffer));
+
+        arena.release();
+        CHECK(arena.allocate(100) == first);
+    }
+
+    // Relocation copies the used part into the arena or onto the heap.
+    {
+        Arena arena;
+        char const data[] = "0123456789";
+        char* moved = static_cast<char*>(Arena::relocate(&arena, data, 10, 64));
+
+        CHECK(memcmp(moved, data, 10) == 0);
+
+        char* heap = static_cast<char*>(Arena::relocate(null, data, 10, 64));
+
+        CHECK(memcmp(heap, data, 10) == 0);
+        free(heap);
+    }
+
+    // A document holds the same tree as a value.
+    std::string text = makeText(3000);
+    std::string result = expected(text);
+
+    {
+        Document document(1024);
+
+        CHECK(document.parseString(text));
+        CHECK(save(document.root()) == result);
+        CHECK(document.root()[7]["name"].asString() == "hhhhhhh");
+        CHECK(document.root().size() == 3000);
+        CHECK(document.arena().used() >= text.size() / 4);
+    }
+
+    // Parsing again drops the previous tree and reuses the memory.
+    {
+        Document document;
+        std::string small = "{\"a\": [1, \"two\"], \"b\": {\"c\": null}}";
+
+        CHECK(document.parseString(text));
+        CHECK(document.parseString(small));
+        CHECK(save(document.root()) == expected(small));
+        CHECK(document.arena().used() < text.size() / 4);
+        CHECK(document.parseString(text));
+        CHECK(save(document.root()) == result);
+
+        document.clear();
+        CHECK(document.root().type() == Value::untyped);
+        CHECK(document.arena().used() == 0);
+    }
+
+    // A failed parse leaves an empty document.
+    {
+        Document document;
+        ParseError error;
+        Value value;
+        ParseError value_error;
+        std::string broken = text.substr(0, text.size() / 2) + "@";
+
+        CHECK(not document.parseString(broken, &error));
+        CHECK(not value.parseString(broken, &value_error));
+        CHECK(error.code == value_error.code and error.offset == value_error.offset);
+        CHECK(document.root().type() == Value::untyped);
+        CHECK(document.arena().used() == 0);
+    }
+
+    // The in-situ parse, the strict grammar, raw numbers and huge pages.
+    {
+        std::string buffer = text;
+        Document document(JSON_ARENA_BLOCK_SIZE, true);
+
+        CHECK(document.parseInSitu(&buffer[0], &buffer[0] + buffer.size()));
+        CHECK(save(document.root()) == result);
+        CHECK(document.parse<StrictGrammar>(text.data(), text.data() + text.size()));
+        CHECK(save(document.root()) == result);
+        CHECK(not document.parse<StrictGrammar>("[1,]", "[1,]" + 4));
+        CHECK(document.parseString("[1.50, 2]", null, true));
+        CHECK(save(document.root()) == "[1.50, 2]");
+    }
+
+    // A document over a buffer of the caller.
+    {
+        std::vector<char> buffer(4096);
+        Document document(buffer.data(), buffer.size());
+
+        CHECK(document.parseString("{\"k\": [\"v\", 1]}"));
+        CHECK(save(document.root()) == expected("{\"k\": [\"v\", 1]}"));
+        CHECK(document.parseString(text));
+        CHECK(save(document.root()) == result);
+    }
+
+    // Copies taken from the tree outlive the document and can grow.
+    {
+        Value copy;
+        Value element;
+
+        {
+            Document document(1024);
+
+            CHECK(document.parseString(text));
+            copy = document.root();
+            element = document.root()[11];
+        }
+
+        CHECK(save(copy) == result);
+
+        for (int i = 0; i < 100; ++i)
+            copy.insert(copy.size(), Value(i));
+
+        element.insert("extra", Value(std::string(100, 'x')));
+        element["name"] = Value(std::string("renamed"));
+        CHECK(copy.size() == 3100);
+        CHECK(element["extra"].asString() == std::string(100, 'x'));
+        CHECK(element["name"].asString() == "renamed");
+        CHECK(element["id"].asInteger() == 11);
+    }
+
+    return CHECK_RESULT();
+}
@@ -0,0 +1,148 @@
+/*
+ * dom.cpp
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <string>
+#include <vector>
+
+#include <json/json.h>
+
+#include "check.h"
+
+using namespace json;
+
+namespace {
+
+std::string dump(Value const& value)
+{
+    std::string result;
+    value.saveToString(&result);
+    return result;
+}
+
+} // namespace
+
+int main()
+{
+    // A large array is parsed straight into its slots.
+    std::string text = "[";
+
+    for (int ix = 0; ix < 1000000; ++ix)
+        text += (ix ? ",\"" : "\"") + std::to_string(ix) + "\"";
+
+    text += "]";
+    Value big;
+
+    CHECK(big.parseString(text));
+    CHECK(big.size() == 1000000);
+    CHECK(big[0].asString() == "0");
+    CHECK(big[999999].asString() == "999999");
+    CHECK(big[123456].asString() == "123456");
+
+    // Growth, removal and resizing keep every element exactly once.
+    Array array;
+
+    for (int ix = 0; ix < 1000; ++ix)
+        array.append(Value(std::to_string(ix)));
+
+    CHECK(array.numItems() == 1000);
+    CHECK(array.reserved() >= 1000);
+
+    array.remove(0);
+    array.remove(500);
+    CHECK(array.numItems() == 998);
+    CHECK(array[0].asString() == "1");
+    CHECK(array[500].asString() == "502");
+    CHECK(array[997].asString() == "999");
+
+    array.resize(10);
+    CHECK(array.numItems() == 10);
+    array.resize(20);
+    CHECK(array.numItems() == 20);
+    CHECK(array[9].asString() == "10");
+    CHECK(not array[10].isUsed());
+    array[10] = Value("again");
+    CHECK(array[10].asString() == "again");
+
+    array.clear();
+    CHECK(array.numItems() == 0);
+    array.append(Value("fresh"));
+    CHECK(array[0].asString() == "fresh");
+
+    Value grown(Value::typeArray);
+    grown[4] = Value(4);
+    CHECK(grown.size() == 5);
+    CHECK(grown[4].asInteger() == 4);
+
+    // Maps keep every key through the rehashes, and copies can look them up.
+    Value map(Value::typeMap);
+
+    for (int ix = 0; ix < 5000; ++ix)
+        map["key" + std::to_string(ix)] = Value(ix);
+
+    CHECK(map.size() == 5000);
+
+    for (int ix = 0; ix < 5000; ++ix)
+    {
+        if (not map.hasKey("key" + std::to_string(ix)))
+        {
+            CHECK(not "key lost");
+            break;
+        }
+    }
+
+    Map copy = map.asMap();
+    std::vector<char const*> keys;
+
+    CHECK(copy.numItems() == 5000);
+    CHECK(copy.hasKey("key4999"));
+    CHECK(copy["key1234"].asInteger() == 1234);
+    copy.getKeys(&keys);
+    CHECK(keys.size() == 5000);
+
+    // The empty key is a key like any other, not an empty slot.
+    CHECK(not copy.hasKey(""));
+    copy.insert("", Value(1));
+    CHECK(copy.hasKey(""));
+    CHECK(copy.numItems() == 5001);
+
+    // Parsed containers compare equal to built ones.
+    Value parsed;
+    Value built(Value::typeMap);
+    Value inner(Value::typeMap);
+
+    CHECK(parsed.parseString("{\"a\": [1, {\"b\": [2, 3]}], \"c\": \"d\"}"));
+    inner["b"] = Value(Value::typeArray);
+    inner["b"][0] = Value(2);
+    inner["b"][1] = Value(3);
+    built["a"] = Value(Value::typeArray);
+    built["a"][0] = Value(1);
+    built["a"][1] = inner;
+    built["c"] = Value("d");
+    CHECK(dump(parsed) == dump(built));
+
+    return CHECK_RESULT();
+}
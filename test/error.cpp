@@ -0,0 +1,107 @@
+/*
+ * error.cpp
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <string.h>
+
+#include <string>
+
+#include <json/jsonvalue.h>
+
+#include "check.h"
+
+using namespace json;
+
+namespace {
+
+ParseError parse(std::string const& text)
+{
+    Value value;
+    ParseError error;
+
+    if (value.parseString(text, &error))
+        CHECK(not error);
+
+    return error;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void expect(std::string const& text, ParseError::Code code, Uint offset)
+{
+    int failures = check_failures;
+    ParseError error = parse(text);
+
+    CHECK(error.code == code);
+    CHECK(error.offset == offset);
+
+    if (check_failures != failures)
+        fprintf(::stderr, "    input: %s\n", text.c_str());
+}
+
+} // namespace
+
+int main()
+{
+    expect("", ParseError::errorUnexpectedEnd, 0);
+    expect("  ", ParseError::errorUnexpectedEnd, 2);
+    expect("[1, 2", ParseError::errorUnexpectedEnd, 5);
+    expect("{\"a\" 1}", ParseError::errorExpectedColon, 5);
+    expect("{1: 2}", ParseError::errorExpectedString, 1);
+    expect("tru", ParseError::errorInvalidLiteral, 0);
+    expect("[nul]", ParseError::errorInvalidLiteral, 1);
+    expect("[1, /* x", ParseError::errorUnterminatedComment, 8);
+    expect(std::string("[1,\0]", 5), ParseError::errorUnexpectedNull, 3);
+
+    // Line and column are counted from the offset only on request.
+    char const* text = "{\n  \"a\": tru\n}";
+    ParseError error = parse(text);
+    Uint line = 0;
+    Uint column = 0;
+
+    CHECK(error.code == ParseError::errorInvalidLiteral);
+    CHECK(error.offset == 9);
+    error.position(text, &line, &column);
+    CHECK(line == 2);
+    CHECK(column == 8);
+    CHECK(strcmp(error.message(), "Invalid literal") == 0);
+
+    CHECK(error);
+    error.clear();
+    CHECK(not error);
+    CHECK(error.offset == 0);
+    CHECK(strcmp(error.message(), "No error") == 0);
+
+    // A failed parse leaves the value as it was.
+    Value value;
+    CHECK(value.parseString("[1, 2]"));
+    CHECK(not value.parseString("[3, "));
+    CHECK(value.size() == 2);
+
+    // The error is optional.
+    CHECK(not value.parseString("{"));
+
+    return CHECK_RESULT();
+}
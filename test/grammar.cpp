@@ -0,0 +1,136 @@
+/*
+ * grammar.cpp
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include <json/json.h>
+
+#include "check.h"
+
+using namespace json;
+
+namespace {
+
+struct Case
+{
+    char const*         text;
+    ParseError::Code    strict_code;
+    Uint                strict_offset;
+    char const*         relaxed;
+};
+
+/*
+ * Parses the text with the grammar, copied and in place; both must agree.
+ */
+template<typename Grammar>
+std::string parse(std::string const& text, ParseError* error)
+{
+    Value value;
+    Value in_situ;
+    ParseError in_situ_error;
+    std::vector<char> buffer(text.begin(), text.end());
+    std::string result;
+
+    bool ok = value.parseData<Grammar>(text.data(), text.data() + text.size(), error);
+    bool in_situ_ok = in_situ.parseDataInSitu<Grammar>(buffer.data(), buffer.data() + buffer.size(), &in_situ_error);
+
+    CHECK(ok == in_situ_ok);
+    CHECK(error->code == in_situ_error.code);
+    CHECK(error->offset == in_situ_error.offset);
+
+    if (ok)
+        value.saveToString(&result);
+
+    return result;
+}
+
+} // namespace
+
+int main()
+{
+    // What only the relaxed grammar accepts, and where the strict one stops.
+    Case const extensions[] = {
+        {"[1 /* c */]", ParseError::errorUnexpectedSymbol, 3, "[1]"},
+        {"[1] // c", ParseError::errorUnexpectedSymbol, 4, "[1]"},
+        {"[1, 2,]", ParseError::errorUnexpectedSymbol, 6, "[1, 2]"},
+        {"{\"a\": 1,}", ParseError::errorExpectedString, 8, "{\"a\": 1}"},
+        {"[0x1F]", ParseError::errorUnexpectedSymbol, 2, "[31]"},
+        {"[\"\\x41\"]", ParseError::errorInvalidEscape, 2, "[\"A\"]"},
+        {"[\"\\v\"]", ParseError::errorInvalidEscape, 2, "[\"\\u000b\"]"},
+        {"[1,\f2]", ParseError::errorUnexpectedSymbol, 3, "[1, 2]"},
+        {"[1,\v2]", ParseError::errorUnexpectedSymbol, 3, "[1, 2]"},
+        {"[1]\b", ParseError::errorUnexpectedSymbol, 3, "[1]"},
+        {"[\"a\tb\"]", ParseError::errorUnexpectedSymbol, 3, "[\"a\\tb\"]"},
+        {"[\"a\x01z\"]", ParseError::errorUnexpectedSymbol, 3, "[\"a\\u0001z\"]"},
+    };
+
+    for (Case const& item : extensions)
+    {
+        int failures = check_failures;
+        ParseError strict_error;
+        ParseError relaxed_error;
+
+        CHECK(parse<StrictGrammar>(item.text, &strict_error).empty());
+        CHECK(strict_error.code == item.strict_code);
+        CHECK(strict_error.offset == item.strict_offset);
+        CHECK(parse<RelaxedGrammar>(item.text, &relaxed_error) == item.relaxed);
+        CHECK(not relaxed_error);
+
+        if (check_failures != failures)
+            fprintf(::stderr, "    input: %s\n", item.text);
+    }
+
+    // Stray commas are no extension of either grammar.
+    char const* stray[] = {"[1,,2]", "[,1]", "{,}", "{\"a\": 1,,}", "[1,]x"};
+
+    for (char const* text : stray)
+    {
+        ParseError strict_error;
+        ParseError relaxed_error;
+
+        CHECK(parse<StrictGrammar>(text, &strict_error).empty() and strict_error);
+        CHECK(parse<RelaxedGrammar>(text, &relaxed_error).empty() and relaxed_error);
+    }
+
+    // Plain JSON reads the same both ways.
+    std::string plain = "{\"a\": [1, -2.5e3, true, false, null], \"b\": \"t\\u00e9xt \\\\ \\/\", \"c\": {}}";
+    ParseError strict_error;
+    ParseError relaxed_error;
+
+    CHECK(parse<StrictGrammar>(plain, &strict_error) == parse<RelaxedGrammar>(plain, &relaxed_error));
+    CHECK(not strict_error and not relaxed_error);
+
+    // The plain entry points keep the relaxed grammar.
+    Value value;
+    CHECK(value.parseString("[1, /* c */ 0x10,]"));
+    CHECK(value.size() == 2 and value[1].asInteger() == 16);
+
+    return CHECK_RESULT();
+}
@@ -0,0 +1,324 @@
+/*
+ * index.cpp
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include <json/jsonindex.h>
+#include <json/jsonvalue.h>
+
+#include "check.h"
+
+using namespace json;
+
+namespace {
+
+/*
+ * The same index found one byte at a time; false when it is not plain.
+ */
+template<typename Grammar>
+bool referenceIndex(std::string const& text, std::vector<Uint>& result)
+{
+    bool in_string = false;
+    bool escaped = false;
+    bool in_scalar = false;
+    bool plain = true;
+
+    result.clear();
+
+    for (Uint ix = 0; ix < text.size(); ++ix)
+    {
+        char c = text[ix];
+
+        if (in_string)
+        {
+            if (escaped)
+                escaped = false;
+            else if (c == '\\')
+                escaped = true;
+            else if (c == '"')
+                in_string = false;
+
+            continue;
+        }
+
+        if (c == '"')
+        {
+            result.push_back(ix);
+            in_string = true;
+            in_scalar = false;
+        }
+        else if (strchr("{}[]:,", c))
+        {
+            result.push_back(ix);
+            in_scalar = false;
+        }
+        else if (c == ' ' or c == '\t' or c == '\n' or c == '\r'
+                 or (Grammar::allowExtraSpaces and (c == '\b' or c == '\v' or c == '\f')))
+        {
+            in_scalar = false;
+        }
+        else if (Grammar::allowComments and c == '/' and ix + 1 < text.size() and (text[ix + 1] == '/' or text[ix + 1] == '*'))
+        {
+            char kind = text[ix + 1];
+
+            result.push_back(ix);
+            in_scalar = false;
+            plain = false;
+
+            /* the loop of Scanner::skipComment() */
+            for (ix += 2; ix < text.size(); ++ix)
+            {
+                if (text[ix] == '\\')
+                    ++ix;
+                else if (kind == '/' and text[ix] == '\n')
+                    break;
+                else if (kind == '*' and text[ix] == '*' and ix + 1 < text.size() and text[ix + 1] == '/')
+                {
+                    ++ix;
+                    break;
+                }
+            }
+        }
+        else
+        {
+            if (not in_scalar)
+                result.push_back(ix);
+
+            if (c == '/' or c == '\\')
+                plain = false;
+
+            in_scalar = true;
+        }
+    }
+
+    result.push_back(text.size());
+    return plain;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Grammar = RelaxedGrammar>
+void compare(std::string const& text)
+{
+    int failures = check_failures;
+    std::vector<Uint> expected;
+    StructuralIndex index;
+    bool expected_plain = referenceIndex<Grammar>(text, expected);
+
+    CHECK(index.build<Grammar>(text.data(), text.data() + text.size()));
+    CHECK(index.plain() == expected_plain);
+    CHECK(index.numItems() == expected.size());
+    CHECK(std::vector<Uint>(index.begin(), index.end()) == expected);
+
+    if (check_failures != failures)
+        fprintf(::stderr, "    input: %s\n", text.c_str());
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*
+ * `piece` as the last items of an array that is large enough for the index,
+ * read the same as the array of the piece alone, which is not: the same items
+ * or the same error, moved by the length of the items before them.
+ */
+template<typename Grammar = RelaxedGrammar>
+void compareLarge(std::string const& piece)
+{
+    int failures = check_failures;
+
+    for (Uint count = 400; count < 464; ++count)
+    {
+        std::string filler = "[";
+        std::string small = "[" + piece + "]";
+
+        for (Uint ix = 0; ix < count; ++ix)
+            filler += "0, ";
+
+        std::string large = filler + piece + "]";
+        Value small_value;
+        Value large_value;
+        ParseError small_error;
+        ParseError large_error;
+        bool small_ok = small_value.parseData<Grammar>(small.data(), small.data() + small.size(), &small_error);
+        bool large_ok = large_value.parseData<Grammar>(large.data(), large.data() + large.size(), &large_error);
+
+        CHECK(small_ok == large_ok);
+
+        if (small_ok and large_ok)
+        {
+            std::string small_text;
+            std::string large_text;
+
+            small_value.saveToString(&small_text);
+            large_value.saveToString(&large_text);
+
+            CHECK(large_text == filler + small_text.substr(1));
+        }
+        else
+        {
+            CHECK(large_error.code == small_error.code);
+            CHECK(large_error.offset == small_error.offset + filler.size() - 1);
+        }
+
+        if (check_failures != failures)
+        {
+            fprintf(::stderr, "    piece: %s\n", piece.c_str());
+            break;
+        }
+    }
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*
+ * A document with strings that hold structural characters, escaped quotes
+ * and runs of backslashes, shifted by `pad` bytes so that every token lands
+ * on a 64 byte block boundary sooner or later.
+ */
+std::string makeDocument(Uint pad, Uint count, char const* space)
+{
+    std::string text(pad, ' ');
+    text += "{";
+
+    for (Uint ix = 0; ix < count; ++ix)
+    {
+        if (ix)
+            text += std::string(",") + space;
+
+        text += "\"key" + std::to_string(ix) + "\"" + space + ":" + space;
+
+        switch (ix % 5)
+        {
+            case 0: text += "[1, -2.5e3, true, false, null]"; break;
+            case 1: text += "\"{b} [c], \\\"e\\\"\""; break;
+            case 2: text += "\"\\\\\\\\\\\\\\\"\\\\\""; break;
+            case 3: text += "{\"x\":" + std::to_string(ix * 7919) + "}"; break;
+            case 4: text += "\"/* c */ \\\\\""; break;
+        }
+    }
+
+    text += "}";
+    return text;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+std::string makeTree(Uint count, char const* space)
+{
+    std::string text = "{";
+
+    for (Uint ix = 0; ix < count; ++ix)
+    {
+        if (ix)
+            text += std::string(",") + space;
+
+        text += "\"key" + std::to_string(ix) + "\"" + space + ":" + space;
+        text += ix % 2 ? "[1, -2.5e3, true, false, null]" : "{\"x\":" + std::to_string(ix * 7919) + "}";
+    }
+
+    text += "}";
+    return text;
+}
+
+} // namespace
+
+int main()
+{
+    compare("");
+    compare("1");
+    compare("  [1,2 , 3]  ");
+    compare("{\"a\": \"b\\\"c\", \"d\": [true, null]}");
+    compare("[1, /* comment */ 2]");
+    compare("[1, 2] // comment");
+    compare("[\"a\\\"\", \\x]");
+    compare("[1, /* \"{\" \\*/ */ 2, // \"\n 3]");
+    compare("[1/2, 3 / 4, /x]");
+    compare("[1, /* unterminated \"");
+    compare("[1, // to the end \\");
+
+    // The strict index has no comments and only four spaces.
+    compare<StrictGrammar>("[1, /* \"{\" */ 2]");
+    compare<StrictGrammar>("[1,\v2,\f 3, \b]");
+    compare<StrictGrammar>("[\"a\\\"/\", \\x]");
+
+    for (Uint pad = 0; pad < 64; ++pad)
+    {
+        compare(makeDocument(pad, 40, " "));
+        compare(makeDocument(pad, 40, ""));
+        compare(makeDocument(pad, 40, "\n\t  "));
+        compare(makeDocument(pad, 40, " /* \"{x}\" \\*/ **/"));
+        compare(makeDocument(pad, 40, "// \"[\\\n\n"));
+        compare<StrictGrammar>(makeDocument(pad, 40, "\n\t  "));
+        compare<StrictGrammar>(makeDocument(pad, 40, " /* \"{x}\" */\v"));
+    }
+
+    // Whitespace skipped through the index gives the same tree as none.
+    std::string compact = makeTree(200, "");
+    std::string spaced = makeTree(200, "\n        ");
+    std::string commented = spaced;
+    commented.insert(1, "/* a comment */");
+
+    Value a, b, c;
+    std::string a_text, b_text, c_text;
+
+    CHECK(a.parseString(compact) and a.saveToString(&a_text));
+    CHECK(b.parseString(spaced) and b.saveToString(&b_text));
+    CHECK(c.parseString(commented) and c.saveToString(&c_text));
+    CHECK(a.size() == 200);
+    CHECK(a_text == b_text);
+    CHECK(a_text == c_text);
+
+    // Values read at the positions of the index, around comments and stray
+    // bytes the index passes over, and errors at the same offsets.
+    compareLarge("1, /* \"not a string\" { */ 2");
+    compareLarge("\"a\\\"b\" // line, \"\n, 3");
+    compareLarge("/* \\*/ still */ 4 /**/, /*/ */ 5");
+    compareLarge("[\"\\\\\", \"\\\\\\\"\"], {\"k\" /* c */ : /* d */ \"v\"}");
+    compareLarge("1\b,\f2");
+    compareLarge("5 // the end");
+    compareLarge("1 / 2");
+    compareLarge("1/2");
+    compareLarge("1 /x/ 2");
+    compareLarge("\\x");
+    compareLarge("1 \\\"a\"");
+    compareLarge("\"a\" x");
+    compareLarge("tru");
+    compareLarge("12abc, 3");
+    compareLarge("1 2");
+    compareLarge("\"x\\q\"");
+    compareLarge("/* unterminated \"");
+
+    compareLarge<StrictGrammar>("\"a\\\"b/\",\r\n[\"\\\\\"],\t3");
+    compareLarge<StrictGrammar>("1 /* \"c\" */ 2");
+    compareLarge<StrictGrammar>("1 // c");
+    compareLarge<StrictGrammar>("1,\v2");
+    compareLarge<StrictGrammar>("1\f");
+    compareLarge<StrictGrammar>("1 \\\"a\"");
+    compareLarge<StrictGrammar>("\"a\" x");
+
+    return CHECK_RESULT();
+}
@@ -0,0 +1,126 @@
+/*
+ * insitu.cpp
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include <json/jsonvalue.h>
+
+#include "check.h"
+
+using namespace json;
+
+namespace {
+
+std::string dump(Value const& value)
+{
+    std::string result;
+    value.saveToString(&result);
+    return result;
+}
+
+} // namespace
+
+int main()
+{
+    // The same tree as a copying parse, with keys pointing into the buffer.
+    std::string text = "{\"name\": \"caf\\u00e9\", \"list\": [1, 2.5, true, null, \"a\\nb\"], "
+            "\"k\\\"ey\": {\"inner\": \"x\"}}";
+    std::vector<char> buffer(text.begin(), text.end());
+    Value copied;
+    Value borrowed;
+
+    CHECK(copied.parseString(text));
+    CHECK(borrowed.parseDataInSitu(buffer.data(), buffer.data() + buffer.size()));
+    CHECK(dump(borrowed) == dump(copied));
+    CHECK(borrowed.hasKey("k\"ey"));
+    CHECK(borrowed["list"][4].asString() == "a\nb");
+
+    for (Value::const_iterator it = borrowed.begin(); it != borrowed.end(); ++it)
+    {
+        char const* key = borrowed.getKey(it);
+
+        if (key)
+        {
+            CHECK(key > buffer.data() and key < buffer.data() + buffer.size());
+            CHECK(key[-1] == '"');
+        }
+    }
+
+    // Strings are borrowed until a copy is made: the copy owns its data.
+    // Those of up to 8 bytes are kept in the value itself.
+    char small[] = "[\"abc\", \"abcdefghijk\"]";
+    Value value;
+
+    CHECK(value.parseDataInSitu(small, small + strlen(small)));
+    Value copy = value;
+    small[2] = 'X';
+    small[9] = 'X';
+    CHECK(value[0].asString() == "abc");
+    CHECK(value[1].asString() == "Xbcdefghijk");
+    CHECK(copy[1].asString() == "abcdefghijk");
+
+    // Many borrowed keys survive the rehashes of the map.
+    std::string many = "{";
+
+    for (int ix = 0; ix < 1000; ++ix)
+        many += (ix ? ", \"key" : "\"key") + std::to_string(ix) + "\": " + std::to_string(ix);
+
+    many += "}";
+    std::vector<char> many_buffer(many.begin(), many.end());
+    Value map;
+
+    CHECK(map.parseDataInSitu(many_buffer.data(), many_buffer.data() + many_buffer.size()));
+    CHECK(map.size() == 1000);
+
+    for (int ix = 0; ix < 1000; ix += 37)
+    {
+        std::string key = "key" + std::to_string(ix);
+        CHECK(map.hasKey(key));
+        CHECK(map[key].asInteger() == ix);
+    }
+
+    // Errors are reported the same way, and the target is left alone.
+    char const* bad_inputs[] = {"[\"a\\qb\"]", "[1, 2", "{\"a\" 1}", "[\"a\xff\"]", "{\"a\": \"b"};
+
+    for (char const* bad : bad_inputs)
+    {
+        std::vector<char> bad_buffer(bad, bad + strlen(bad));
+        ParseError error;
+        ParseError expected;
+
+        CHECK(not copied.parseString(bad, &expected));
+        CHECK(not value.parseDataInSitu(bad_buffer.data(), bad_buffer.data() + bad_buffer.size(), &error));
+        CHECK(error.code == expected.code);
+        CHECK(error.offset == expected.offset);
+        CHECK(value[1].asString() == "Xbcdefghijk");
+    }
+
+    return CHECK_RESULT();
+}
@@ -0,0 +1,145 @@
+/*
+ * intern.cpp
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+
+#include <string>
+
+#include <json/json.h>
+#include <json/jsondocument.h>
+
+#include "check.h"
+
+using namespace json;
+
+namespace {
+
+std::string save(Value const& value)
+{
+    std::string result;
+
+    value.saveToString(&result);
+    return result;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*
+ * An array of `count` copies of a string of `length` bytes.
+ */
+std::string repeated(int count, Uint length)
+{
+    std::string text = "[";
+
+    for (int i = 0; i < count; ++i)
+        text += (i ? ", \"" : "\"") + std::string(length, 'r') + "\"";
+
+    return text + "]";
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+size_t used(std::string const& text, bool intern)
+{
+    Document document;
+
+    document.setInternStrings(intern);
+    CHECK(document.parseString(text));
+
+    return document.arena().used();
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*
+ * Interning changes where the strings are, not what they are.
+ */
+void checkSame(std::string const& text)
+{
+    int failures = check_failures;
+    Value expected;
+    Document document;
+
+    CHECK(expected.parseString(text));
+    document.setInternStrings(true);
+    CHECK(document.internStrings());
+
+    // Twice, so the second parse does not see the table of the first.
+    CHECK(document.parseString(text));
+    CHECK(save(document.root()) == save(expected));
+    CHECK(document.parseString(text));
+    CHECK(save(document.root()) == save(expected));
+
+    if (check_failures != failures)
+        fprintf(::stderr, "    input: %.60s...\n", text.c_str());
+}
+
+} // namespace
+
+int main()
+{
+    // Strings of up to 8 bytes take no memory of their own.
+    CHECK(used(repeated(1000, 9), false) >= used(repeated(1000, 8), false) + 1000 * 9);
+    CHECK(used(repeated(1000, 8), false) == used(repeated(1000, 1), false));
+
+    Value inline_string(std::string("12345678"));
+    Value copy(inline_string);
+
+    CHECK(copy.asString() == "12345678");
+    inline_string = Value(std::string("abc"));
+    CHECK(copy.asString() == "12345678" and inline_string.asString() == "abc");
+
+    // Repeated values are kept once, long ones are copied as before.
+    Document document;
+
+    CHECK(not document.internStrings());
+    CHECK(used(repeated(1000, 50), true) + 1000 * 50 <= used(repeated(1000, 50), false));
+    CHECK(used(repeated(1000, 200), true) >= 1000 * 200);
+
+    checkSame(repeated(1000, 50));
+    checkSame(repeated(100, 200));
+
+    // Distinct, escaped and nearly equal strings stay apart.
+    std::string text = "[";
+
+    for (int i = 0; i < 5000; ++i)
+    {
+        std::string word = "value number " + std::to_string(i % 2500);
+
+        text += (i ? ", " : "");
+        text += "{\"key\": \"" + word + "\", \"escaped\": \"" + (i % 2 ? "a\\nb" : "a\\\\nb") +
+                "\", \"" + word + "\": \"" + word + "x\"}";
+    }
+
+    text += "]";
+    checkSame(text);
+
+    // In-situ parses borrow their strings either way.
+    std::string buffer = repeated(100, 50);
+
+    document.setInternStrings(true);
+    CHECK(document.parseInSitu(&buffer[0], &buffer[0] + buffer.size()));
+    CHECK(save(document.root()) == repeated(100, 50));
+
+    return CHECK_RESULT();
+}
@@ -0,0 +1,271 @@
+/*
+ * keypool.cpp
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+
+#include <string.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <json/json.h>
+#include <json/jsondocument.h>
+#include <json/jsonkeypool.h>
+#include <json/jsonmap.h>
+
+#include "check.h"
+
+using namespace json;
+
+namespace {
+
+std::string save(Value const& value)
+{
+    std::string result;
+
+    value.saveToString(&result);
+    return result;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+std::string makeText(int count, std::string const& prefix)
+{
+    std::string text = "[";
+
+    for (int i = 0; i < count; ++i)
+    {
+        text += (i ? ", " : "");
+        text += "{\"" + prefix + "id\": " + std::to_string(i) + ", \"" + prefix + "name\": \"n" +
+                std::to_string(i) + "\", \"" + prefix + std::to_string(i % 10) + "\": [true]}";
+    }
+
+    return text + "]";
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*
+ * The document matches a plain parse, and the keys of its pool find the
+ * members.
+ */
+void checkDocument(Document& document, std::string const& text, std::string const& prefix)
+{
+    int failures = check_failures;
+    Value expected;
+
+    CHECK(expected.parseString(text));
+    CHECK(document.parseString(text));
+    CHECK(save(document.root()) == save(expected));
+
+    Key id = document.keyPool().find((prefix + "id").c_str());
+    Key name = document.keyPool().find((prefix + "name").c_str());
+
+    CHECK(id.data != null and name.data != null);
+
+    for (Uint i = 0; i < document.root().size(); i += 7)
+    {
+        CHECK(document.root()[int(i)].hasKey(id));
+        CHECK(document.root()[int(i)][id].asInteger() == Integer(i));
+        CHECK(document.root()[int(i)][name].asString() == "n" + std::to_string(i));
+    }
+
+    if (check_failures != failures)
+        fprintf(::stderr, "    prefix: %s\n", prefix.c_str());
+}
+
+} // namespace
+
+int main()
+{
+    // One copy of every key, with the hash code of Map.
+    {
+        KeyPool pool;
+        std::string text = "name";
+        Key first = pool.intern("name");
+        Key second = pool.intern(&text[0], 4);
+
+        CHECK(first.data == second.data);
+        CHECK(first.data != text.data());
+        CHECK(first.length == 4 and strcmp(first.data, "name") == 0);
+        CHECK(first.code == Map::hashCode("name", 4));
+        CHECK(pool.intern("other").data != first.data);
+        CHECK(pool.intern("", 0).length == 0);
+        CHECK(pool.numKeys() == 3);
+
+        CHECK(pool.find("name").data == first.data);
+        CHECK(pool.find("nam", 3).data == null);
+        CHECK(pool.find("missing").data == null);
+
+        // The keys stay where they are while the table grows.
+        std::vector<Key> keys;
+
+        for (int i = 0; i < 10000; ++i)
+            keys.push_back(pool.intern(("key" + std::to_string(i)).c_str()));
+
+        CHECK(pool.numKeys() == 10003);
+
+        for (int i = 0; i < 10000; ++i)
+        {
+            std::string key = "key" + std::to_string(i);
+
+            CHECK(pool.find(key.c_str()).data == keys[i].data);
+            CHECK(strcmp(keys[i].data, key.c_str()) == 0);
+        }
+
+        pool.clear();
+        CHECK(pool.numKeys() == 0);
+        CHECK(pool.find("name").data == null);
+        CHECK(strcmp(pool.intern("name").data, "name") == 0);
+    }
+
+    // The texts can come from an arena of the caller.
+    {
+        Arena arena;
+        KeyPool pool(&arena);
+
+        CHECK(arena.used() == 0);
+        pool.intern("some key");
+        CHECK(arena.used() > 0);
+    }
+
+    // Maps look Keys up by pointer or, for keys of other pools, by text.
+    {
+        KeyPool pool;
+        KeyPool other;
+        Value map(Value::typeMap);
+
+        map[pool.intern("a")] = Value(1);
+        map["b"] = Value(2);
+
+        CHECK(map.hasKey(pool.intern("a")));
+        CHECK(map.hasKey(other.intern("a")));
+        CHECK(map.hasKey(pool.intern("b")));
+        CHECK(not map.hasKey(pool.intern("c")));
+        CHECK(map[other.intern("b")].asInteger() == 2);
+        CHECK(map[pool.intern("a")].asInteger() == 1);
+
+        // Inserted keys are copied.
+        {
+            KeyPool scratch;
+            map[scratch.intern("d")] = Value(4);
+        }
+
+        CHECK(map["d"].asInteger() == 4);
+    }
+
+    // A document keeps its keys in its own pool.
+    {
+        Document document;
+        std::string text = makeText(1000, "");
+
+        checkDocument(document, text, "");
+        CHECK(document.keyPool().numKeys() == 12);
+    }
+
+    // A shared pool collects the keys of every document that uses it.
+    {
+        KeyPool pool;
+        Document first;
+        Document second;
+
+        first.setKeyPool(&pool);
+        second.setKeyPool(&pool);
+        CHECK(&first.keyPool() == &pool);
+
+        checkDocument(first, makeText(500, "a"), "a");
+        checkDocument(second, makeText(500, "b"), "b");
+        CHECK(pool.numKeys() == 24);
+        CHECK(first.keyPool().find("bid").data == second.keyPool().find("bid").data);
+
+        second.setKeyPool(null);
+        CHECK(&second.keyPool() != &pool);
+        checkDocument(second, makeText(500, "c"), "c");
+        CHECK(pool.numKeys() == 24);
+    }
+
+    // The global pool is shared by threads.
+    {
+        KeyPool& pool = KeyPool::global();
+        std::vector<std::thread> threads;
+        std::vector<std::vector<Key>> keys(4);
+        std::vector<int> failures(4, 0);
+
+        CHECK(&pool == &KeyPool::global());
+
+        for (int t = 0; t < 4; ++t)
+        {
+            threads.emplace_back([t, &keys, &failures]()
+            {
+                Document document;
+                std::string text = makeText(300, "g");
+                Value expected;
+
+                document.setKeyPool(&KeyPool::global());
+
+                for (int i = 0; i < 2000; ++i)
+                    keys[t].push_back(KeyPool::global().intern(("global" + std::to_string(i)).c_str()));
+
+                for (int round = 0; round < 5; ++round)
+                {
+                    if (not document.parseString(text) or not expected.parseString(text) or
+                        save(document.root()) != save(expected))
+                    {
+                        ++failures[t];
+                    }
+                }
+            });
+        }
+
+        for (std::thread& thread : threads)
+            thread.join();
+
+        for (int t = 0; t < 4; ++t)
+        {
+            CHECK(failures[t] == 0);
+
+            for (int i = 0; i < 2000; ++i)
+                CHECK(keys[t][i].data == keys[0][i].data);
+        }
+
+        CHECK(pool.find("global1999").data == keys[0][1999].data);
+        CHECK(pool.find("gname").data != null);
+
+        // Maps of other threads may still borrow its keys, so it keeps them.
+        Document document;
+
+        document.setKeyPool(&pool);
+        CHECK(document.parseString("{\"kept\": 1}"));
+
+        Uint num_keys = pool.numKeys();
+
+        pool.clear();
+        CHECK(pool.numKeys() == num_keys);
+        CHECK(pool.find("global1999").data == keys[0][1999].data);
+        CHECK(document.root()[pool.find("kept")].asInteger() == 1);
+    }
+
+    return CHECK_RESULT();
+}
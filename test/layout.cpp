@@ -0,0 +1,173 @@
+/*
+ * layout.cpp
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+
+#include <string.h>
+
+#include <string>
+#include <utility>
+
+#include <json/json.h>
+#include <json/jsondocument.h>
+
+#include "check.h"
+
+using namespace json;
+
+namespace {
+
+std::string save(Value const& value)
+{
+    std::string result;
+
+    value.saveToString(&result);
+    return result;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*
+ * Copies and moves of a parsed value, which must not depend on the buffer
+ * it was parsed from.
+ */
+void checkCopies(std::string const& text, bool raw_numbers)
+{
+    int failures = check_failures;
+    Value expected;
+    std::string buffer = text;
+    Value in_situ;
+
+    CHECK(expected.parseString(text, null, raw_numbers));
+    CHECK(in_situ.parseDataInSitu(&buffer[0], &buffer[0] + buffer.size(), null, raw_numbers));
+    CHECK(save(in_situ) == save(expected));
+
+    Value copy(in_situ);
+    Value assigned;
+    Value element = in_situ[0];
+
+    assigned = in_situ;
+
+    // The borrowed texts are gone, the copies keep theirs.
+    buffer.assign(buffer.size(), '#');
+    CHECK(save(copy) == save(expected));
+    CHECK(save(assigned) == save(expected));
+    CHECK(save(element) == save(expected[0]));
+
+    Value moved(std::move(copy));
+    Value move_assigned;
+
+    move_assigned = std::move(assigned);
+    CHECK(save(moved) == save(expected));
+    CHECK(save(move_assigned) == save(expected));
+
+    if (check_failures != failures)
+        fprintf(::stderr, "    input: %s\n", text.c_str());
+}
+
+} // namespace
+
+int main()
+{
+    // A payload, a length, the type and the flags.
+    CHECK(sizeof(Value) == 16);
+
+    // Arrays of scalars are dense.
+    Value array;
+
+    CHECK(array.parseString("[1, 2.5, true, null, \"s\"]"));
+    CHECK(&array[1] - &array[0] == 1);
+    CHECK(reinterpret_cast<char const*>(&array[4]) - reinterpret_cast<char const*>(&array[0]) == 4 * 16);
+
+    // Strings of every length and with zero bytes inside.
+    for (Uint length = 1; length < 40; ++length)
+    {
+        std::string text(length, 'x');
+        Value value(text);
+        Value copy(value);
+        Value array(Value::typeArray);
+
+        array.insert(Uint(0), value);
+        CHECK(value.type() == Value::typeString);
+        CHECK(value.asString() == text);
+        CHECK(copy.asString() == text);
+        CHECK(save(array) == "[\"" + text + "\"]");
+    }
+
+    Value zero;
+
+    CHECK(zero.parseString("[\"a\\u0000b\"]"));
+    CHECK(zero[0].asString() == std::string("a\0b", 3));
+    CHECK(save(zero) == "[\"a\\u0000b\"]");
+
+    // Raw numbers up to 8 bytes and longer ones keep their text.
+    Value numbers;
+
+    CHECK(numbers.parseString("[1.5e+10, 1.50e+100, 0.10000000000000000000000000001, -12345678]", null, true));
+    CHECK(save(numbers) == "[1.5e+10, 1.50e+100, 0.10000000000000000000000000001, -12345678]");
+    CHECK(numbers[0].asDouble() == 1.5e10);
+    CHECK(numbers[1].asDouble() == 1.5e100);
+    CHECK(numbers[2].asDouble() == 0.1);
+    CHECK(numbers[3].asInteger() == -12345678);
+
+    // Copies out of in-situ buffers and documents own their texts.
+    char const* text = "[\"a long string that does not fit anywhere inline\", {\"key\": \"v\", "
+                       "\"k2\": [1.25, 123456789.123456789, \"esc\\taped\"]}, 0.000000000000000000001]";
+
+    checkCopies(text, false);
+    checkCopies(text, true);
+
+    Value copy;
+
+    {
+        Document document;
+
+        CHECK(document.parseString(text, null, true));
+        copy = document.root();
+    }
+
+    Value expected;
+
+    CHECK(expected.parseString(text, null, true));
+    CHECK(save(copy) == save(expected));
+
+    // Containers kept out of line still grow and shrink like before.
+    Value map(Value::typeMap);
+
+    for (int i = 0; i < 1000; ++i)
+        map[std::to_string(i)] = Value(i);
+
+    map.remove("500");
+    CHECK(map.size() == 999);
+    CHECK(not map.hasKey("500"));
+    CHECK(map["999"].asInteger() == 999);
+
+    Value swapped(Value::typeArray);
+
+    swapped.swap(map);
+    CHECK(swapped.size() == 999 and map.size() == 0 and map.type() == Value::typeArray);
+
+    return CHECK_RESULT();
+}
@@ -0,0 +1,150 @@
+/*
+ * lazy.cpp
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <string>
+
+#include <json/json.h>
+#include <json/jsonlazy.h>
+
+#include "check.h"
+
+using namespace json;
+
+namespace {
+
+std::string dump(Value const& value)
+{
+    std::string result;
+    value.saveToString(&result);
+    return result;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*
+ * The lazy document must fail where Value::parseData() fails, with the
+ * same error.
+ */
+template<typename Grammar>
+void checkError(std::string const& text)
+{
+    int failures = check_failures;
+    LazyDocument doc;
+    Value value;
+    ParseError lazy_error;
+    ParseError value_error;
+
+    CHECK(not doc.parse<Grammar>(text.data(), text.data() + text.size(), &lazy_error));
+    CHECK(not value.parseData<Grammar>(text.data(), text.data() + text.size(), &value_error));
+    CHECK(lazy_error.code == value_error.code);
+    CHECK(lazy_error.offset == value_error.offset);
+
+    if (check_failures != failures)
+        fprintf(::stderr, "    input: %s\n", text.c_str());
+}
+
+} // namespace
+
+int main()
+{
+    std::string text = "{\"skip\": [[1, [2, {\"a\": 3}]], {\"x\": {}}], \"n\": -12, \"d\": 2.5, "
+            "\"s\": \"caf\\u00e9\", \"t\": true, \"z\": null, \"list\": [10, \"eleven\", [12], {\"k\": 13}]}";
+    LazyDocument doc;
+    Value value;
+
+    CHECK(doc.parse(text));
+    CHECK(value.parseString(text));
+
+    // Lookups jump over the nested containers and convert only what they reach.
+    CHECK(doc.root().isMap());
+    CHECK(doc.root().size() == 7);
+    CHECK(doc["n"].isInteger() and doc["n"].asInteger() == -12);
+    CHECK(doc["d"].isDouble() and doc["d"].asDouble() == 2.5);
+    CHECK(doc["s"].isString() and doc["s"].asString() == "caf\xc3\xa9");
+    CHECK(doc["t"].isBoolean() and doc["t"].asBoolean());
+    CHECK(doc["z"].isNull());
+    CHECK(doc["list"].isArray() and doc["list"].size() == 4);
+    CHECK(doc["list"][1].asString() == "eleven");
+    CHECK(doc["list"][2][0].asInteger() == 12);
+    CHECK(doc["list"][3]["k"].asInteger() == 13);
+    CHECK(doc["skip"][0][1][1]["a"].asInteger() == 3);
+    CHECK(doc.root().hasKey("z") and not doc.root().hasKey("missing"));
+
+    // What is not there is untyped, and lookups on it chain.
+    CHECK(not doc["missing"].isUsed());
+    CHECK(not doc["missing"]["deeper"][3].isUsed());
+    CHECK(not doc["list"][4].isUsed());
+    CHECK(not doc["list"][-1].isUsed());
+    CHECK(not doc["n"]["key"].isUsed());
+
+    // Converted subtrees are the ones a full parse builds.
+    CHECK(dump(doc.root().toValue()) == dump(value));
+    CHECK(dump(doc["list"].toValue()) == dump(value["list"]));
+    CHECK(doc["list"][3].raw().length == 9);
+
+    // Only the brackets are checked up front.
+    ParseError error;
+    CHECK(not doc.parse("{\"a\": [1, 2}", &error));
+    CHECK(error.code == ParseError::errorUnexpectedSymbol);
+    CHECK(not doc.parse("[[1, 2]", &error));
+    CHECK(error.code == ParseError::errorUnexpectedEnd);
+    std::string unchecked = "[1, tru]";
+    CHECK(doc.parse(unchecked));
+    CHECK(doc[0].asInteger() == 1);
+
+    // Without comments the document reads the input in place.
+    std::string plain = "{\"a\": [1, 2], \"b\": \"x\"}";
+
+    CHECK(doc.parse(plain));
+    CHECK(doc["a"][1].asInteger() == 2);
+    CHECK(doc["b"].raw().data == plain.data() + 19);
+
+    // Comments are blanked in a copy, and only under the relaxed grammar.
+    std::string commented = "{\"a\": 1 /* one ] */, \"b\": [2] // two }\n}";
+
+    CHECK(doc.parse(commented));
+    CHECK(doc["a"].asInteger() == 1);
+    CHECK(doc["b"][0].asInteger() == 2);
+    CHECK(doc["b"].raw().data != commented.data() + commented.find('['));
+
+    checkError<StrictGrammar>(commented);
+
+    // The reported error is the real one, not a guess at offset 0.
+    checkError<RelaxedGrammar>("{\"a\": \\1}");
+    checkError<StrictGrammar>("{\"a\": \\1}");
+    checkError<RelaxedGrammar>("[1, /* c */ \\2]");
+    checkError<RelaxedGrammar>("[1, /* c ]");
+
+    // A strict document also converts the values it reaches strictly.
+    std::string hex = "[0x10]";
+
+    CHECK(doc.parse(hex));
+    CHECK(doc[0].isInteger() and doc[0].asInteger() == 16);
+    CHECK(doc.parse<StrictGrammar>(hex.data(), hex.data() + hex.size()));
+    CHECK(not doc[0].isInteger());
+
+    return CHECK_RESULT();
+}
@@ -0,0 +1,353 @@
+/*
+ * map.cpp
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <json/json.h>
+#include <json/jsonmap.h>
+
+#include "check.h"
+
+using namespace json;
+
+namespace {
+
+/*
+ * The map holds exactly the items of the reference, and its iteration visits
+ * each of them once.
+ */
+void checkSame(Map const& map, std::map<std::string, Integer> const& reference)
+{
+    int failures = check_failures;
+    Uint visited = 0;
+
+    CHECK(map.numItems() == reference.size());
+    CHECK(map.numItems() <= map.capacity());
+    CHECK(Uint(map.end() - map.begin()) == map.numItems());
+
+    for (std::map<std::string, Integer>::const_iterator it = reference.begin(); it != reference.end(); ++it)
+    {
+        CHECK(map.hasKey(it->first.c_str()));
+        CHECK(map[it->first].asInteger() == it->second);
+    }
+
+    for (json::const_iterator it = map.begin(); it != map.end(); ++it)
+    {
+        char const* key = map.getKey(it);
+
+        if (key)
+        {
+            CHECK(reference.count(key) == 1);
+            CHECK(it->asInteger() == reference.at(key));
+            ++visited;
+        }
+    }
+
+    std::vector<char const*> keys;
+
+    map.getKeys(&keys);
+    CHECK(keys.size() == reference.size());
+    CHECK(visited == reference.size());
+
+    if (check_failures != failures)
+        fprintf(::stderr, "    items: %u\n", Uint(reference.size()));
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*
+ * Iteration follows the order of insertion.
+ */
+void checkOrder(Map const& map, std::vector<std::string> const& order)
+{
+    int failures = check_failures;
+    std::vector<char const*> keys;
+
+    CHECK(map.numItems() == order.size());
+    map.getKeys(&keys);
+    CHECK(keys.size() == order.size());
+
+    for (Uint i = 0; i < order.size() and i < map.numItems(); ++i)
+    {
+        CHECK(map.getKey(map.begin() + i) == order[i]);
+        CHECK(keys[i] == order[i]);
+    }
+
+    if (check_failures != failures)
+        fprintf(::stderr, "    items: %u\n", Uint(order.size()));
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*
+ * The map must hold exactly the keys, in this order, each with the number
+ * it was inserted with.
+ */
+bool matches(Map const& map, std::vector<int> const& keys)
+{
+    Uint ix = 0;
+
+    if (map.numItems() != keys.size())
+        return false;
+
+    for (Map::const_iterator it = map.begin(); it != map.end(); ++it, ++ix)
+    {
+        std::string key = "key" + std::to_string(keys[ix]);
+
+        if (key != map.getKey(it) or it->asInteger() != keys[ix])
+            return false;
+
+        if (not map.hasKey(key.c_str()) or map[key].asInteger() != keys[ix])
+            return false;
+    }
+
+    return true;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void fill(Map* map, std::vector<int>* keys, int count)
+{
+    map->clear();
+    keys->clear();
+
+    for (int ix = 0; ix < count; ++ix)
+    {
+        (*map)["key" + std::to_string(ix)] = Value(ix);
+        keys->push_back(ix);
+    }
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void removeKey(Map* map, std::vector<int>* keys, int key)
+{
+    CHECK(map->remove(("key" + std::to_string(key)).c_str()));
+    keys->erase(std::find(keys->begin(), keys->end(), key));
+}
+
+} // namespace
+
+int main()
+{
+    // Random inserts, replacements and removals against std::map.
+    Map map;
+    std::map<std::string, Integer> reference;
+
+    srand(24);
+
+    for (int round = 0; round < 20; ++round)
+    {
+        for (int i = 0; i < 5000; ++i)
+        {
+            std::string key = "k" + std::to_string(rand() % 3000);
+            Integer value = rand();
+
+            switch (rand() % 4)
+            {
+                case 0:
+                    map[key] = Value(value);
+                    reference[key] = value;
+                    break;
+                case 1:
+                    map.replace(key.c_str(), Value(value));
+                    reference[key] = value;
+                    break;
+                case 2:
+                    CHECK(map.remove(key.c_str()) == (reference.erase(key) == 1));
+                    break;
+                default:
+                    CHECK(map.hasKey(key.c_str()) == (reference.count(key) == 1));
+                    CHECK(not map[key.c_str()].isUsed() or map[key].asInteger() == reference[key]);
+                    reference[key] = map[key].isUsed() ? reference[key] : 0;
+                    map[key] = Value(reference[key]);
+                    break;
+            }
+        }
+
+        checkSame(map, reference);
+    }
+
+    // Removing everything leaves no traces behind.
+    while (not reference.empty())
+    {
+        CHECK(map.remove(reference.begin()->first.c_str()));
+        reference.erase(reference.begin());
+    }
+
+    checkSame(map, reference);
+    CHECK(not map.remove("k1"));
+    CHECK(map["k1"].isUsed() == false);
+
+    // Keys that differ in a few characters, and empty and long ones.
+    Map similar;
+    std::map<std::string, Integer> similar_reference;
+
+    for (int i = 0; i < 20000; ++i)
+    {
+        std::string key = std::string(i % 64, 'x') + std::to_string(i);
+
+        similar.insert(key, Value(i));
+        similar_reference[key] = i;
+    }
+
+    similar[""] = Value(-1);
+    similar_reference[""] = -1;
+    checkSame(similar, similar_reference);
+
+    // Reserving makes room without growing later.
+    Map reserved;
+
+    reserved.reserve(1000);
+    Uint capacity = reserved.capacity();
+
+    for (int i = 0; i < 1000; ++i)
+        reserved.insert(std::to_string(i), Value(i));
+
+    CHECK(reserved.capacity() == capacity);
+    CHECK(reserved.numItems() == 1000);
+
+    // Copies, moves and swaps.
+    Map copy(similar);
+    Map assigned;
+
+    assigned = similar;
+    checkSame(copy, similar_reference);
+    checkSame(assigned, similar_reference);
+
+    Map moved(std::move(copy));
+
+    checkSame(moved, similar_reference);
+    moved.swap(reserved);
+    CHECK(moved.numItems() == 1000 and reserved.numItems() == 20001);
+
+    similar.clear();
+    CHECK(similar.numItems() == 0 and not similar.hasKey("x1"));
+    checkSame(assigned, similar_reference);
+
+    // The order of insertion survives growth, removals, copies and values.
+    Map ordered;
+    std::vector<std::string> order;
+
+    for (int i = 0; i < 3000; ++i)
+    {
+        std::string key = "o" + std::to_string((i * 7919) % 3000);
+
+        ordered[key] = Value(i);
+        order.push_back(key);
+
+        if (i % 5 == 4)
+        {
+            Uint victim = Uint(rand()) % order.size();
+
+            CHECK(ordered.remove(order[victim].c_str()));
+            order.erase(order.begin() + victim);
+        }
+    }
+
+    ordered[order[10]] = Value(-1);
+    ordered.replace(order[20].c_str(), Value(-2));
+    checkOrder(ordered, order);
+    checkOrder(Map(ordered), order);
+
+    while (order.size() > 10)
+    {
+        CHECK(ordered.remove(order[order.size() / 2].c_str()));
+        order.erase(order.begin() + order.size() / 2);
+    }
+
+    checkOrder(ordered, order);
+
+    Value object;
+    std::string text;
+
+    CHECK(object.parseString("{\"z\": 1, \"a\": 2, \"m\": 3, \"b\": 4}"));
+    object.remove("a");
+    object["c"] = Value(5);
+    object.saveToString(&text);
+    CHECK(text == "{\"z\": 1, \"m\": 3, \"b\": 4, \"c\": 5}");
+
+    // Removals from the back, from the front, every other one and at random;
+    // the rest keeps its order and stays reachable.
+    Map removal;
+    std::vector<int> keys;
+    int const count = 3000;
+
+    fill(&removal, &keys, count);
+
+    for (int ix = count; ix-- > count / 2;)
+        removeKey(&removal, &keys, ix);
+
+    CHECK(matches(removal, keys));
+
+    for (int ix = 0; ix < count / 4; ++ix)
+        removeKey(&removal, &keys, ix);
+
+    CHECK(matches(removal, keys));
+
+    fill(&removal, &keys, count);
+
+    for (int ix = 0; ix < count; ix += 2)
+        removeKey(&removal, &keys, ix);
+
+    CHECK(matches(removal, keys));
+
+    fill(&removal, &keys, count);
+    srand(1);
+
+    while (keys.size() > 10)
+    {
+        removeKey(&removal, &keys, keys[rand() % keys.size()]);
+
+        if (keys.size() % 500 == 0)
+            CHECK(matches(removal, keys));
+    }
+
+    CHECK(matches(removal, keys));
+    CHECK(not removal.remove("key-1"));
+
+    // Emptied and refilled, the map works as new.
+    std::vector<int> left(keys);
+
+    for (int key : left)
+        removeKey(&removal, &keys, key);
+
+    CHECK(removal.numItems() == 0 and removal.begin() == removal.end());
+
+    for (int ix = 0; ix < 100; ++ix)
+    {
+        removal["key" + std::to_string(ix)] = Value(ix);
+        keys.push_back(ix);
+    }
+
+    CHECK(matches(removal, keys));
+
+    return CHECK_RESULT();
+}
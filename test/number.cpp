@@ -0,0 +1,217 @@
+/*
+ * number.cpp
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <locale.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+
+#include <json/jsonnumber.h>
+#include <json/jsonvalue.h>
+
+#include "check.h"
+
+using namespace json;
+
+namespace {
+
+uint64_t random_state = 0x2545F4914F6CDD1DULL;
+
+uint64_t random64()
+{
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 7;
+    random_state ^= random_state << 17;
+    return random_state;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool sameBits(double a, double b)
+{
+    return ::memcmp(&a, &b, sizeof(double)) == 0;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+Number parse(std::string const& text, Uint* length = null)
+{
+    Number number;
+    char const* end = Number::parse(text.data(), text.data() + text.size(), &number);
+
+    if (length)
+        *length = end ? Uint(end - text.data()) : Uint(-1);
+
+    return number;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool isInvalid(std::string const& text)
+{
+    Number number;
+    return Number::parse(text.data(), text.data() + text.size(), &number) == null;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*
+ * The double must come out bit for bit as strtod() rounds it.
+ */
+void compareDouble(std::string const& text)
+{
+    int failures = check_failures;
+    Uint length = 0;
+    Number number = parse(text, &length);
+    double expected = ::strtod(text.c_str(), null);
+
+    CHECK(length == text.size());
+    CHECK(number.type == Number::typeDouble);
+    CHECK(sameBits(number.real, expected));
+
+    if (check_failures != failures)
+    {
+        fprintf(::stderr, "    input: %s\n", text.c_str());
+        exit(1);
+    }
+}
+
+} // namespace
+
+int main()
+{
+    Uint length = 0;
+
+    // Integers stay integers as long as they fit.
+    CHECK(parse("0").type == Number::typeInteger);
+    CHECK(parse("-0").integer == 0);
+    CHECK(parse("1234567890123").integer == 1234567890123LL);
+    CHECK(parse("9223372036854775807").integer == INT64_MAX);
+    CHECK(parse("-9223372036854775808").integer == INT64_MIN);
+    CHECK(parse("9223372036854775808").type == Number::typeDouble);
+    CHECK(parse("9223372036854775808").real == 9223372036854775808.0);
+    CHECK(parse("-9223372036854775809").type == Number::typeDouble);
+    CHECK(parse("100000000000000000000000").real == 1e23);
+    CHECK(parse("1.0").type == Number::typeDouble);
+    CHECK(parse("1e2").type == Number::typeDouble);
+
+    // The grammar is JSON's, and the number ends where its characters do.
+    CHECK(isInvalid(""));
+    CHECK(isInvalid("-"));
+    CHECK(isInvalid("+1"));
+    CHECK(isInvalid(".5"));
+    CHECK(isInvalid("01"));
+    CHECK(isInvalid("-01"));
+    CHECK(isInvalid("1."));
+    CHECK(isInvalid("1.e5"));
+    CHECK(isInvalid("1e"));
+    CHECK(isInvalid("1e+"));
+    CHECK(parse("12]", &length).integer == 12 and length == 2);
+    CHECK(parse("1.5e3,", &length).real == 1500.0 and length == 5);
+
+    std::string bounded = "12345";
+    Number number;
+    CHECK(Number::parse(bounded.data(), bounded.data() + 3, &number) == bounded.data() + 3);
+    CHECK(number.integer == 123);
+
+    // Fast path, Eisel-Lemire, subnormals, overflow and underflow.
+    char const* doubles[] = {
+        "0.1", "-0.0", "1e23", "8.98846567431158e307", "1.7976931348623157e308", "1.7976931348623159e308",
+        "2.2250738585072011e-308", "2.2250738585072014e-308", "4.9406564584124654e-324", "2.4703282292062327e-324",
+        "2.4703282292062328e-324", "1e-400", "1e400", "-1e400", "7.2057594037927933e16", "123456789012345678901234567890",
+        "0.000000000000000000000000000000000000000000001e300", "3.141592653589793238462643383279502884197",
+        "9007199254740993.0", "9007199254740993.00000000000000000000", "9007199254740993.00000000000000000001",
+        "1.00000000000000011102230246251565404236316680908203125", "1.00000000000000011102230246251565404236316680908203124",
+        "1.00000000000000011102230246251565404236316680908203126",
+        "7.4109846876186981626485318930233205854758970392148714663837852375101326090531312779794975454245398856969484704316857659638998506553390969459816219401617281718945106978546710679176872575177347315553307795408549809608457500958111373034747658096871009590975442271004757307809711118935784838675653998783503015228055934046593739791790738723868299395818481660169122019456499931289798411362062484498678713572180352209017023903285791732520220528974020802906854021606612375549983402671300035812486479041385743401875520901590172592547146296175134159774938718574737870961645638908718119841271673056017045493004705269590165763776884908267986972573366521765567941072508764337560846003984904972149117463085539556354188641513168478436313080237596295773983001708984374999e-324",
+    };
+
+    for (char const* text : doubles)
+        compareDouble(text);
+
+    // The halfway cases with more than 19 digits can only be rounded by the
+    // fallback, which has to see every digit.
+    CHECK(parse("9007199254740993.00000000000000000000").real == 9007199254740992.0);
+    CHECK(parse("9007199254740993.00000000000000000001").real == 9007199254740994.0);
+
+    // Every double survives a round trip through its shortest exact text.
+    for (int ix = 0; ix < 100000; ++ix)
+    {
+        uint64_t bits = random64();
+        double value;
+        ::memcpy(&value, &bits, sizeof(value));
+
+        if (value != value or value - value != 0)
+            continue;
+
+        char text[64];
+        ::snprintf(text, sizeof(text), "%.17g", value);
+
+        if (::strchr(text, '.') or ::strchr(text, 'e'))
+            compareDouble(text);
+    }
+
+    // Random digit strings of every length with random exponents.
+    for (int ix = 0; ix < 100000; ++ix)
+    {
+        std::string text;
+        int digits = 1 + int(random64() % 30);
+        int point = int(random64() % digits);
+
+        text += char('1' + random64() % 9);
+
+        for (int jx = 1; jx < digits; ++jx)
+        {
+            if (jx == point)
+                text += '.';
+
+            text += char('0' + random64() % 10);
+        }
+
+        text += "e" + std::to_string(int(random64() % 700) - 350);
+        compareDouble(text);
+    }
+
+    // The decimal point of the current locale does not matter.
+    if (::setlocale(LC_NUMERIC, "de_DE.UTF-8") or ::setlocale(LC_NUMERIC, "ru_RU.UTF-8"))
+    {
+        CHECK(parse("1.5").real == 1.5);
+        CHECK(parse("9007199254740993.00000000000000000001").real == 9007199254740994.0);
+        ::setlocale(LC_NUMERIC, "C");
+    }
+
+    // The parser takes numbers through the same path.
+    Value value;
+    CHECK(value.parseString("[-12, 0.5, 1e2, 18446744073709551616]"));
+    CHECK(value[0].isInteger() and value[0].asInteger() == -12);
+    CHECK(value[1].isDouble() and value[1].asDouble() == 0.5);
+    CHECK(value[2].isDouble() and value[2].asDouble() == 100.0);
+    CHECK(value[3].isDouble() and value[3].asDouble() == 18446744073709551616.0);
+    CHECK(not value.parseString("[01]"));
+    CHECK(not value.parseString("[1.]"));
+    CHECK(not value.parseString("[-]"));
+
+    return CHECK_RESULT();
+}
@@ -0,0 +1,155 @@
+/*
+ * parallel.cpp
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <string>
+
+#include <json/json.h>
+
+#include "check.h"
+
+using namespace json;
+
+namespace {
+
+/*
+ * Parses the text sequentially and on several threads: both must give the
+ * same value or fail with the same error.
+ */
+void compare(std::string const& text, Uint num_threads = 4)
+{
+    int failures = check_failures;
+    Value sequential;
+    Value parallel;
+    ParseError sequential_error;
+    ParseError parallel_error;
+
+    bool sequential_ok = sequential.parseData(text.data(), text.data() + text.size(), &sequential_error);
+    bool parallel_ok = parallel.parseDataParallel(text.data(), text.data() + text.size(), &parallel_error, num_threads);
+
+    CHECK(sequential_ok == parallel_ok);
+    CHECK(sequential_error.code == parallel_error.code);
+    CHECK(sequential_error.offset == parallel_error.offset);
+
+    if (sequential_ok and parallel_ok)
+    {
+        std::string sequential_text;
+        std::string parallel_text;
+
+        sequential.saveToString(&sequential_text);
+        parallel.saveToString(&parallel_text);
+        CHECK(sequential_text == parallel_text);
+    }
+
+    if (check_failures != failures)
+        fprintf(::stderr, "    input: %.60s..., threads: %u\n", text.c_str(), num_threads);
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*
+ * A top-level array large enough to be split, with the given member in the
+ * middle.
+ */
+std::string bigArray(std::string const& member)
+{
+    std::string filler;
+
+    for (int ix = 0; ix < 20000; ++ix)
+        filler += "{\"id\": " + std::to_string(ix) + ", \"name\": \"member\"},";
+
+    return "[" + filler + member + "," + filler + "1]";
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+std::string bigObject(std::string const& member)
+{
+    std::string filler;
+
+    for (int ix = 0; ix < 40000; ++ix)
+        filler += "\"key\\u0020" + std::to_string(ix) + "\": [" + std::to_string(ix) + ", \"value\", {}],\n";
+
+    return "{" + filler + member + ", \"last\": null}";
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+std::string nested(Uint depth)
+{
+    return std::string(depth, '[') + std::string(depth, ']');
+}
+
+} // namespace
+
+int main()
+{
+    for (Uint threads = 1; threads <= 4; ++threads)
+    {
+        compare(bigArray("true"), threads);
+        compare(bigObject("\"middle\": true"), threads);
+    }
+
+    // Errors inside a member are reported at their offset in the document.
+    compare(bigArray("tru"));
+    compare(bigArray("{\"a\": [1, 2,, 3]}"));
+    compare(bigArray("\"bad \\q escape\""));
+    compare(bigObject("\"middle\": [1 2]"));
+
+    // Anything irregular at the top level is left to the sequential parser.
+    compare(bigArray("1 2"));
+    compare(bigObject("\"middle\" 1"));
+    compare(bigObject("\"middle\": 1,"));
+    compare(bigArray("/* comment */ 1"));
+    compare(bigArray("1") + "x");
+    compare(bigArray("1").substr(1));
+
+    // The top-level array counts: its members may nest one level less.
+    compare(bigArray(nested(JSON_MAX_DEPTH - 2)));
+    compare(bigArray(nested(JSON_MAX_DEPTH - 1)));
+    compare(bigArray(nested(JSON_MAX_DEPTH)));
+    compare(bigArray(nested(JSON_MAX_DEPTH + 10)));
+
+    std::string deepest = bigArray(nested(JSON_MAX_DEPTH - 1));
+    std::string too_deep = bigArray(nested(JSON_MAX_DEPTH));
+    Value limited;
+    ParseError error;
+
+    CHECK(limited.parseDataParallel(deepest.data(), deepest.data() + deepest.size(), null, 4));
+    CHECK(not limited.parseDataParallel(too_deep.data(), too_deep.data() + too_deep.size(), &error, 4));
+    CHECK(error.code == ParseError::errorDepthLimit);
+
+    // Small documents and scalar roots go the sequential way.
+    compare("[1, 2, 3]");
+    compare("\"" + std::string(2 << 20, 'x') + "\"");
+
+    Value value;
+    std::string text = bigObject("\"middle\": {\"deep\": [1, 2, 3]}");
+
+    CHECK(value.parseDataParallel(text.data(), text.data() + text.size()));
+    CHECK(value.size() == 40002);
+    CHECK(value["middle"]["deep"][2].asInteger() == 3);
+    CHECK(value["key 39999"][0].asInteger() == 39999);
+
+    return CHECK_RESULT();
+}
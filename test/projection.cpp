@@ -0,0 +1,156 @@
+/*
+ * projection.cpp
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <string>
+
+#include <json/json.h>
+#include <json/jsonprojection.h>
+
+#include "check.h"
+
+using namespace json;
+
+namespace {
+
+std::string project(Projection const& projection, std::string const& data)
+{
+    Value result;
+    std::string text;
+
+    if (not projection.parse(data, &result))
+        return "error";
+
+    result.saveToString(&text);
+
+    return text;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool expect(Projection const& projection, std::string const& data, std::string const& expected)
+{
+    std::string text = project(projection, data);
+
+    if (text != expected)
+        fprintf(::stderr, "    got %s, expected %s\n", text.c_str(), expected.c_str());
+
+    return text == expected;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+ParseError::Code errorOf(Projection const& projection, std::string const& data, bool check_rest = false)
+{
+    Value result;
+    ParseError error;
+
+    projection.parse(data, &result, &error, check_rest);
+
+    return error.code;
+}
+
+} // namespace
+
+int main()
+{
+    std::string document = "{\"a\": {\"b\": 1, \"c\": [1, 2]}, \"d\": \"x\", \"e\": [{\"x\": 1}, {\"x\": 2, \"y\": 3}]}";
+
+    // Only the requested subtrees are built.
+    CHECK(expect({"/a/c", "/d"}, document, "{\"a\": {\"c\": [1, 2]}, \"d\": \"x\"}"));
+    CHECK(expect({"/a"}, document, "{\"a\": {\"b\": 1, \"c\": [1, 2]}}"));
+    CHECK(expect({""}, document, "{\"a\": {\"b\": 1, \"c\": [1, 2]}, \"d\": \"x\", \"e\": [{\"x\": 1}, {\"x\": 2, \"y\": 3}]}"));
+    CHECK(expect({"/e/*/x"}, document, "{\"e\": [{\"x\": 1}, {\"x\": 2}]}"));
+    CHECK(expect({"/*/b"}, document, "{\"a\": {\"b\": 1}}"));
+    CHECK(expect({"/e/0"}, document, "{\"e\": [{\"x\": 1}]}"));
+    CHECK(expect({"/a/b", "/a"}, document, "{\"a\": {\"b\": 1, \"c\": [1, 2]}}"));
+    CHECK(expect({"/a~0b", "/c~1d"}, "{\"a~b\": 1, \"c/d\": 2, \"e\": 3}", "{\"a~b\": 1, \"c\\/d\": 2}"));
+
+    Value result;
+    CHECK(Projection({"/missing"}).parse(document, &result));
+    CHECK(not result.isMap() or result.size() == 0);
+
+    Projection projection;
+    CHECK(projection.empty());
+    CHECK(not projection.add("no/slash"));
+    CHECK(projection.add(std::string("/d")));
+    CHECK(not projection.empty());
+    CHECK(expect(projection, document, "{\"d\": \"x\"}"));
+    projection.clear();
+    CHECK(projection.empty());
+
+    // Skipped values are stepped over without being validated.
+    CHECK(expect({"/a", "/c"}, "{\"a\": 1, \"b\": [1, tru, {\"q\": 0x}], \"c\": 2}", "{\"a\": 1, \"c\": 2}"));
+
+    // The containers it walks are checked like Reader checks them.
+    ParseError error;
+    CHECK(not Projection({"/b"}).parse("{\"a\": 1 \"b\": 2}", &result, &error));
+    CHECK(error.code == ParseError::errorUnexpectedSymbol);
+    CHECK(error.offset == 8);
+    CHECK(not Projection({"/b"}).parse("{\"a\": 1, \"b\": tru}", &result, &error));
+    CHECK(error.code == ParseError::errorInvalidLiteral);
+
+    // A wildcard and a named sibling both apply, whatever the order of add().
+    std::string array = "{\"a\": [{\"x\": 1, \"y\": 2}, {\"x\": 3, \"y\": 4}]}";
+
+    CHECK(expect({"/a/*/x", "/a/0/y"}, array, "{\"a\": [{\"x\": 1, \"y\": 2}, {\"x\": 3}]}"));
+    CHECK(expect({"/a/0/y", "/a/*/x"}, array, "{\"a\": [{\"x\": 1, \"y\": 2}, {\"x\": 3}]}"));
+    CHECK(expect({"/a/*", "/a/1/y"}, array, "{\"a\": [{\"x\": 1, \"y\": 2}, {\"x\": 3, \"y\": 4}]}"));
+
+    std::string object = "{\"a\": {\"k\": {\"x\": 1, \"y\": 2}, \"m\": {\"x\": 3, \"y\": 4}}}";
+
+    CHECK(expect({"/a/*/x", "/a/k/y"}, object, "{\"a\": {\"k\": {\"x\": 1, \"y\": 2}, \"m\": {\"x\": 3}}}"));
+    CHECK(expect({"/a/k/y", "/a/*/x"}, object, "{\"a\": {\"k\": {\"x\": 1, \"y\": 2}, \"m\": {\"x\": 3}}}"));
+
+    // Array elements stay at their index.
+    CHECK(expect({"/items/2"}, "{\"items\": [1, 2, 3]}", "{\"items\": [null, null, 3]}"));
+    CHECK(expect({"/other/3/deep"}, "{\"other\": [0, 1, 2, {\"deep\": true}]}", "{\"other\": [null, null, null, {\"deep\": true}]}"));
+    CHECK(expect({"/items/*/price"}, "{\"items\": [{\"price\": 1}, {\"name\": \"x\"}, {\"price\": 3}]}",
+                 "{\"items\": [{\"price\": 1}, null, {\"price\": 3}]}"));
+    CHECK(expect({"/1", "/3"}, "[0, 1, 2, 3, 4]", "[null, 1, null, 3]"));
+
+    // The parse stops once the last path is resolved.
+    CHECK(expect({"/0"}, "[1, 2]", "[1]"));
+    CHECK(expect({"/0"}, "[1, 2", "[1]"));
+    CHECK(expect({"/0"}, "[1, 2] x", "[1]"));
+    CHECK(expect({"/a"}, "{\"a\": 1, \"b\": [", "{\"a\": 1}"));
+    CHECK(expect({"/a/b"}, "{\"a\": {\"b\": 1}", "{\"a\": {\"b\": 1}}"));
+    CHECK(expect({"/a", "/c"}, "{\"a\": 1, \"c\": 2, \"d\": [", "{\"a\": 1, \"c\": 2}"));
+    CHECK(expect({"/*/x"}, "[{\"x\": 1}, {\"x\": 2}", "error"));
+
+    // With check_rest the rest of the input is skipped to check that it is
+    // complete.
+    CHECK(errorOf({"/0"}, "[1, 2]", true) == ParseError::errorNone);
+    CHECK(errorOf({"/0"}, "[1, 2", true) == ParseError::errorUnexpectedEnd);
+    CHECK(errorOf({"/0"}, "[1, 2] x", true) == ParseError::errorUnexpectedSymbol);
+    CHECK(errorOf({"/a"}, "{\"a\": 1, \"b\": [", true) == ParseError::errorUnexpectedEnd);
+    CHECK(errorOf({"/a/b"}, "{\"a\": {\"b\": 1}", true) == ParseError::errorUnexpectedEnd);
+
+    Value checked;
+
+    CHECK(Projection({"/a"}).parse("{\"a\": [1], \"b\": {\"c\": [2, 3]}}", &checked, null, true));
+    CHECK(checked["a"][0].asInteger() == 1 and not checked.hasKey("b"));
+
+    return CHECK_RESULT();
+}
@@ -0,0 +1,257 @@
+/*
+ * rawnumber.cpp
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <limits>
+#include <string>
+
+#include <json/json.h>
+#include <json/jsonnumber.h>
+#include <json/jsonreader.h>
+
+#include "check.h"
+
+using namespace json;
+
+namespace {
+
+/*
+ * Writes the numbers down: raw ones as "r<type>:<text>", others as usual.
+ */
+struct RawHandler
+{
+    std::string log;
+
+    bool add(std::string const& event) { log += event + " "; return true; }
+
+    bool onNull() { return add("n"); }
+    bool onBool(bool value) { return add(value ? "t" : "f"); }
+    bool onInteger(Integer value) { return add("i" + std::to_string(value)); }
+    bool onDouble(double value) { return add("d" + std::to_string(value)); }
+    bool onRawNumber(StringView text, Number::Type type)
+    {
+        return add((type == Number::typeInteger ? "ri:" : "rd:") + std::string(text.data, text.length));
+    }
+    bool onString(StringView value) { return add("s" + std::string(value.data, value.length)); }
+    bool onKey(StringView key) { return add("k" + std::string(key.data, key.length)); }
+    bool onStartObject() { return add("{"); }
+    bool onEndObject() { return add("}"); }
+    bool onStartArray() { return add("["); }
+    bool onEndArray() { return add("]"); }
+};
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*
+ * The same without onRawNumber().
+ */
+struct PlainHandler
+{
+    std::string log;
+
+    bool add(std::string const& event) { log += event + " "; return true; }
+
+    bool onNull() { return add("n"); }
+    bool onBool(bool value) { return add(value ? "t" : "f"); }
+    bool onInteger(Integer value) { return add("i" + std::to_string(value)); }
+    bool onDouble(double value) { return add("d" + std::to_string(value)); }
+    bool onString(StringView value) { return add("s" + std::string(value.data, value.length)); }
+    bool onKey(StringView key) { return add("k" + std::string(key.data, key.length)); }
+    bool onStartObject() { return add("{"); }
+    bool onEndObject() { return add("}"); }
+    bool onStartArray() { return add("["); }
+    bool onEndArray() { return add("]"); }
+};
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<typename Handler>
+std::string events(std::string const& text)
+{
+    Handler handler;
+    Reader<Handler> reader(handler);
+
+    reader.setRawNumbers(true);
+
+    if (not reader.parse(text.data(), text.data() + text.size()))
+        return "<failed>";
+
+    return handler.log;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+std::string save(std::string const& text, bool raw_numbers)
+{
+    Value value;
+    std::string result;
+
+    if (not value.parseString(text, null, raw_numbers))
+        return "<failed>";
+
+    value.saveToString(&result);
+    return result;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*
+ * The copying and in-situ parses agree with and without raw_numbers.
+ */
+void checkSame(std::string const& text)
+{
+    int failures = check_failures;
+    std::string buffer = text;
+    Value raw;
+    Value in_situ;
+    Value plain;
+    std::string raw_text;
+    std::string in_situ_text;
+
+    CHECK(raw.parseString(text, null, true));
+    CHECK(in_situ.parseDataInSitu(&buffer[0], &buffer[0] + buffer.size(), null, true));
+    CHECK(plain.parseString(text));
+
+    raw.saveToString(&raw_text);
+    in_situ.saveToString(&in_situ_text);
+    CHECK(raw_text == in_situ_text);
+    CHECK(raw.size() == plain.size());
+
+    for (Uint i = 0; i < raw.size() and i < plain.size(); ++i)
+    {
+        CHECK(raw[i].type() == plain[i].type());
+        CHECK(in_situ[i].type() == plain[i].type());
+
+        if (plain[i].type() == Value::typeInteger)
+        {
+            CHECK(raw[i].asInteger() == plain[i].asInteger());
+        }
+        else
+        {
+            CHECK(raw[i].asDouble() == plain[i].asDouble());
+        }
+    }
+
+    if (check_failures != failures)
+        fprintf(::stderr, "    input: %s\n", text.c_str());
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void checkFormat(double value)
+{
+    char buffer[Number::formatSize];
+    Uint length = Number::format(value, buffer);
+    Number number;
+
+    CHECK(length > 0 and length <= Uint(Number::formatSize));
+    CHECK(Number::parse(buffer, buffer + length, &number) == buffer + length);
+
+    // Whole values are written without a fraction and read back as integers.
+    double result = number.type == Number::typeDouble ? number.real : double(number.integer);
+
+    CHECK(result == value);
+
+    if (result != value)
+        fprintf(::stderr, "    value: %.17g, text: %.*s\n", value, int(length), buffer);
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+std::string format(double value)
+{
+    char buffer[Number::formatSize];
+    return std::string(buffer, Number::format(value, buffer));
+}
+
+} // namespace
+
+int main()
+{
+    // The text is written back as it was read.
+    char const* numbers = "[1.50, -0, 1e2, 1.0E+2, 100.0, 12345678901234567, "
+                          "3.14159265358979323846264338327950288]";
+
+    CHECK(save(numbers, true) == "[1.50, -0, 1e2, 1.0E+2, 100.0, 12345678901234567, "
+                                 "3.14159265358979323846264338327950288]");
+    CHECK(save(numbers, false) == "[1.5, 0, 100.0, 100.0, 100.0, 12345678901234567, 3.141592653589793]");
+    checkSame(numbers);
+
+    // Reading converts them.
+    Value value;
+
+    CHECK(value.parseString(numbers, null, true));
+    CHECK(value[0].type() == Value::typeDouble and value[0].asDouble() == 1.5);
+    CHECK(value[1].type() == Value::typeInteger and value[1].asInteger() == 0);
+    CHECK(value[2].type() == Value::typeDouble and value[2].asDouble() == 100.0);
+    CHECK(value[5].type() == Value::typeInteger and value[5].asInteger() == 12345678901234567);
+
+    // 0x integers are converted, long numbers are not.
+    std::string digits(80, '7');
+
+    CHECK(save("[0x10, 0x1f]", true) == "[16, 31]");
+    CHECK(save("[" + digits + "]", true) == "[" + digits + "]");
+    CHECK(save("[0." + digits + "]", true) == "[0." + digits + "]");
+    checkSame("[0x10, " + digits + ", 0." + digits + ", -1e-400, 1e400]");
+
+    // The grammar is the same.
+    CHECK(save("[01]", true) == "<failed>");
+    CHECK(save("[1.]", true) == "<failed>");
+    CHECK(save("[-]", true) == "<failed>");
+    CHECK(save("[1e]", true) == "<failed>");
+
+    // The reader passes the text on to onRawNumber(), or converts it.
+    CHECK(events<RawHandler>("{\"a\": [1.50, -7, 2e3, 0x10, true]}") ==
+          "{ ka [ rd:1.50 ri:-7 rd:2e3 i16 t ] } ");
+    CHECK(events<PlainHandler>("{\"a\": [1.50, -7, 2e3, 0x10, true]}") ==
+          "{ ka [ d1.500000 i-7 d2000.000000 i16 t ] } ");
+
+    // The shortest text that reads back the same.
+    CHECK(format(0.1) == "0.1");
+    CHECK(format(100.0) == "100");
+    CHECK(format(-0.0) == "-0");
+    CHECK(format(1.0 / 3) == "0.3333333333333333");
+    CHECK(format(1e22) == "1e+22");
+    CHECK(format(std::numeric_limits<double>::infinity()) == "null");
+    CHECK(format(-std::numeric_limits<double>::infinity()) == "null");
+    CHECK(format(std::numeric_limits<double>::quiet_NaN()) == "null");
+
+    checkFormat(std::numeric_limits<double>::max());
+    checkFormat(std::numeric_limits<double>::min());
+    checkFormat(std::numeric_limits<double>::denorm_min());
+    srand(19);
+
+    for (int i = 0; i < 100000; ++i)
+    {
+        union { unsigned long long bits; double d; } random;
+
+        random.bits = (unsigned long long)(rand()) << 42 ^ (unsigned long long)(rand()) << 21 ^ rand();
+
+        if (isfinite(random.d))
+            checkFormat(random.d);
+    }
+
+    return CHECK_RESULT();
+}
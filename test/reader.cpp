@@ -0,0 +1,141 @@
+/*
+ * reader.cpp
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include <json/jsonreader.h>
+
+#include "check.h"
+
+using namespace json;
+
+namespace {
+
+/*
+ * Writes every event down and stops when the log reaches `limit` events.
+ */
+struct LogHandler
+{
+    std::string log;
+    Uint count = 0;
+    Uint limit = Uint(-1);
+
+    bool add(std::string const& event) { log += event + " "; return ++count < limit; }
+
+    bool onNull() { return add("n"); }
+    bool onBool(bool value) { return add(value ? "t" : "f"); }
+    bool onInteger(Integer value) { return add("i" + std::to_string(value)); }
+    bool onDouble(double value) { return add("d" + std::to_string(value)); }
+    bool onString(StringView value) { return add("s" + std::string(value.data, value.length)); }
+    bool onKey(StringView key) { return add("k" + std::string(key.data, key.length)); }
+    bool onStartObject() { return add("{"); }
+    bool onEndObject() { return add("}"); }
+    bool onStartArray() { return add("["); }
+    bool onEndArray() { return add("]"); }
+};
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+std::string events(std::string const& text)
+{
+    LogHandler handler;
+    Reader<LogHandler> reader(handler);
+
+    if (not reader.parse(text.data(), text.data() + text.size()))
+        return "<failed>";
+
+    // The in-situ mode reports the same events.
+    std::vector<char> buffer(text.begin(), text.end());
+    LogHandler in_situ_handler;
+    Reader<LogHandler> in_situ(in_situ_handler);
+
+    CHECK(in_situ.parseInSitu(buffer.data(), buffer.data() + buffer.size()));
+    CHECK(in_situ_handler.log == handler.log);
+
+    return handler.log;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void expect(std::string const& text, ParseError::Code code, Uint offset)
+{
+    int failures = check_failures;
+    LogHandler handler;
+    Reader<LogHandler> reader(handler);
+    ParseError error;
+
+    CHECK(not reader.parse(text.data(), text.data() + text.size(), &error));
+    CHECK(error.code == code);
+    CHECK(error.offset == offset);
+
+    if (check_failures != failures)
+        fprintf(::stderr, "    input: %s\n", text.c_str());
+}
+
+} // namespace
+
+int main()
+{
+    CHECK(events("{\"a\": [1, -2.5, true, false, null, \"x\"], \"b\": {}, \"c\": []}") ==
+          "{ ka [ i1 d-2.500000 t f n sx ] kb { } kc [ ] } ");
+    CHECK(events("\"plain\"") == "splain ");
+    CHECK(events("[\"e\\u0073c\\naped\", \"\\x41\"]") == "[ sesc\naped sA ] ");
+    CHECK(events("  42  ") == "i42 ");
+
+    // The extensions: comments, trailing commas and hex numbers.
+    CHECK(events("[1, /* two */ 2, // three\n 3,]") == "[ i1 i2 i3 ] ");
+    CHECK(events("{\"a\": 0x1F,}") == "{ ka i31 } ");
+    CHECK(events("[1] // the end") == "[ i1 ] ");
+    CHECK(events("[1] /* the end */") == "[ i1 ] ");
+
+    // The grammar: commas are required and nothing may follow the value.
+    expect("[1 2]", ParseError::errorUnexpectedSymbol, 3);
+    expect("{\"a\": 1 \"b\": 2}", ParseError::errorUnexpectedSymbol, 8);
+    expect("[1]x", ParseError::errorUnexpectedSymbol, 3);
+    expect("[1] [2]", ParseError::errorUnexpectedSymbol, 4);
+    expect("[@]", ParseError::errorUnexpectedSymbol, 1);
+    expect("{\"a\" 1}", ParseError::errorExpectedColon, 5);
+    expect("{1: 2}", ParseError::errorExpectedString, 1);
+    expect("[1, 2", ParseError::errorUnexpectedEnd, 5);
+
+    // A handler returning false stops the parse where it is.
+    for (Uint limit = 1; limit <= 6; ++limit)
+    {
+        char const* text = "[1, [2], {\"k\": 3}]";
+        LogHandler handler;
+        Reader<LogHandler> reader(handler);
+        ParseError error;
+
+        handler.limit = limit;
+        CHECK(not reader.parse(text, text + strlen(text), &error));
+        CHECK(error.code == ParseError::errorAborted);
+        CHECK(handler.count == limit);
+    }
+
+    return CHECK_RESULT();
+}
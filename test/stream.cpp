@@ -0,0 +1,218 @@
+/*
+ * stream.cpp
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+
+#include <json/jsonreader.h>
+#include <json/jsonstream.h>
+
+#include "check.h"
+
+using namespace json;
+
+namespace {
+
+/*
+ * Writes every event down, so two parsers can be compared by their logs.
+ */
+struct LogHandler
+{
+    std::string log;
+
+    bool onNull() { log += "n "; return true; }
+    bool onBool(bool value) { log += value ? "t " : "f "; return true; }
+    bool onInteger(Integer value) { log += "i" + std::to_string(value) + " "; return true; }
+    bool onDouble(double value) { log += "d" + std::to_string(value) + " "; return true; }
+    bool onString(StringView value) { log += "s" + std::string(value.data, value.length) + " "; return true; }
+    bool onKey(StringView key) { log += "k" + std::string(key.data, key.length) + " "; return true; }
+    bool onStartObject() { log += "{ "; return true; }
+    bool onEndObject() { log += "} "; return true; }
+    bool onStartArray() { log += "[ "; return true; }
+    bool onEndArray() { log += "] "; return true; }
+};
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+struct RawHandler : LogHandler
+{
+    bool onRawNumber(StringView text, Number::Type type)
+    {
+        log += (type == Number::typeInteger ? "ri" : "rd") + std::string(text.data, text.length) + " ";
+        return true;
+    }
+};
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*
+ * Parses the text with Reader and with StreamReader fed in chunks of
+ * `chunk` bytes: both must agree on the events and on the error.
+ */
+template<typename Grammar, typename Handler>
+void compare(std::string const& text, Uint chunk, bool raw_numbers = false)
+{
+    int failures = check_failures;
+    Handler reader_handler;
+    Reader<Handler, Grammar> reader(reader_handler);
+    ParseError reader_error;
+
+    reader.setRawNumbers(raw_numbers);
+    bool reader_ok = reader.parse(text.data(), text.data() + text.size(), &reader_error);
+
+    Handler stream_handler;
+    StreamReader<Handler, Grammar> stream(stream_handler);
+    ParseError stream_error;
+
+    stream.setRawNumbers(raw_numbers);
+
+    for (Uint ix = 0; ix < text.size(); ix += chunk)
+    {
+        if (not stream.feed(text.data() + ix, std::min(chunk, Uint(text.size()) - ix)))
+            break;
+    }
+
+    bool stream_ok = stream.finish(&stream_error);
+
+    CHECK(reader_ok == stream_ok);
+    CHECK(stream_ok == stream.done());
+
+    if (reader_ok and stream_ok)
+    {
+        CHECK(reader_handler.log == stream_handler.log);
+    }
+    else if (not reader_ok and not stream_ok)
+    {
+        CHECK(reader_error.code == stream_error.code);
+        CHECK(reader_error.offset == stream_error.offset);
+    }
+
+    if (check_failures != failures)
+        fprintf(::stderr, "    input: %s, chunk: %u\n", text.c_str(), chunk);
+}
+
+} // namespace
+
+int main()
+{
+    char const* inputs[] = {
+        "{\"a\": [1, 2.5, true, null, \"x\"], \"b\": {}}",
+        "{\"escaped \\\"key\\\"\": \"caf\\u00e9 \\ud83d\\ude00 \\n\", \"long\": \"abcdefghijklmnopqrstuvwxyz\"}",
+        "[-0, 1e10, -12345678901234567890, 0.000001, 0x1F, false]",
+        "[1, /* comment */ 2, // comment\n 3,]",
+        "  \"top\"  ",
+        "12345",
+        "[1, 2",
+        "[\"abc",
+        "[1 2]",
+        "{\"a\" 1}",
+        "[tru]",
+        "[\"\\q\"]",
+        "[1]x",
+        "[1, /* open",
+        "[1, 2, ]",
+        "{\"a\": 1, }",
+        "[1 /* comment */, 2]",
+        "[1,\f2]",
+        "{a: 1}",
+    };
+
+    for (char const* input : inputs)
+    {
+        for (Uint chunk = 1; chunk <= 8; ++chunk)
+        {
+            compare<StrictGrammar, LogHandler>(input, chunk);
+            compare<RelaxedGrammar, LogHandler>(input, chunk);
+        }
+
+        compare<StrictGrammar, LogHandler>(input, Uint(strlen(input)));
+        compare<RelaxedGrammar, LogHandler>(input, Uint(strlen(input)));
+    }
+
+    // Raw numbers reach onRawNumber() untouched, or get converted without it.
+    char const* numbers = "[18446744073709551616, -0, 1.50, 1e400, 7]";
+
+    for (Uint chunk = 1; chunk <= 8; ++chunk)
+    {
+        compare<StrictGrammar, RawHandler>(numbers, chunk, true);
+        compare<RelaxedGrammar, RawHandler>(numbers, chunk, true);
+        compare<StrictGrammar, LogHandler>(numbers, chunk, true);
+    }
+
+    RawHandler raw_handler;
+    StreamReader<RawHandler, StrictGrammar> raw(raw_handler);
+
+    raw.setRawNumbers(true);
+    CHECK(raw.feed(numbers, Uint(strlen(numbers))) and raw.finish());
+    CHECK(raw_handler.log == "[ rd18446744073709551616 ri-0 rd1.50 rd1e400 ri7 ] ");
+
+    // A strict stream refuses what only the relaxed grammar allows.
+    LogHandler strict_handler;
+    StreamReader<LogHandler, StrictGrammar> strict(strict_handler);
+    ParseError error;
+
+    strict.feed("[1, /* c */ 2]", 14);
+    CHECK(not strict.finish(&error));
+    CHECK(error.code == ParseError::errorUnexpectedSymbol);
+
+    // A reset reader takes the next document.
+    LogHandler handler;
+    StreamReader<LogHandler> stream(handler);
+
+    CHECK(stream.feed("[1, ", 4) and not stream.done());
+    CHECK(not stream.feed("}", 1) and stream.failed());
+    stream.reset();
+    handler.log.clear();
+    CHECK(stream.feed("{\"a\"", 4) and stream.feed(": 2}", 4) and stream.finish());
+    CHECK(handler.log == "{ ka i2 } ");
+
+    // parseStream() reads the file block by block into the same tree.
+    std::string text = "[";
+
+    for (int ix = 0; ix < 20000; ++ix)
+        text += (ix ? ", {\"key\": \"" : "{\"key\": \"") + std::to_string(ix) + "\", \"n\": " + std::to_string(ix) + "}";
+
+    text += "]";
+
+    FILE* file = ::tmpfile();
+    CHECK(file != null);
+    CHECK(::fwrite(text.data(), 1, text.size(), file) == text.size());
+    ::rewind(file);
+
+    Value from_stream;
+    Value from_string;
+    std::string a, b;
+
+    CHECK(from_stream.parseStream(file));
+    CHECK(from_string.parseString(text));
+    CHECK(from_stream.saveToString(&a) and from_string.saveToString(&b));
+    CHECK(a == b);
+    CHECK(from_stream.size() == 20000);
+    ::fclose(file);
+
+    return CHECK_RESULT();
+}
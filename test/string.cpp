@@ -0,0 +1,119 @@
+/*
+ * string.cpp
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <string>
+
+#include <json/jsonvalue.h>
+
+#include "check.h"
+
+using namespace json;
+
+namespace {
+
+/*
+ * The string held by the one-element array in the text.
+ */
+std::string decode(std::string const& text)
+{
+    Value value;
+
+    if (not value.parseString(text) or value.size() != 1)
+        return "<failed>";
+
+    return value[0].asString();
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void expect(std::string const& text, ParseError::Code code, Uint offset)
+{
+    int failures = check_failures;
+    Value value;
+    ParseError error;
+
+    CHECK(not value.parseString(text, &error));
+    CHECK(error.code == code);
+    CHECK(error.offset == offset);
+
+    if (check_failures != failures)
+        fprintf(::stderr, "    input: %s\n", text.c_str());
+}
+
+} // namespace
+
+int main()
+{
+    // Escapes become the bytes they stand for.
+    CHECK(decode("[\"a\\nb\\tc\\rd\\be\\ff\"]") == "a\nb\tc\rd\be\ff");
+    CHECK(decode("[\"\\\"\\\\\\/\"]") == "\"\\/");
+    CHECK(decode("[\"\\u0041\\u00e9\\u20AC\"]") == "A\xc3\xa9\xe2\x82\xac");
+    CHECK(decode("[\"\\ud83d\\ude00\"]") == "\xf0\x9f\x98\x80");
+    CHECK(decode("[\"\\x41\\x7e\"]") == "A~");
+    CHECK(decode("[\"\xd0\xb9\xe2\x82\xac\xf0\x9f\x98\x80\"]") == "\xd0\xb9\xe2\x82\xac\xf0\x9f\x98\x80");
+
+    expect("[\"\\q\"]", ParseError::errorInvalidEscape, 2);
+    expect("[\"\\u12\"]", ParseError::errorInvalidEscape, 2);
+    expect("[\"ab\\ud800\"]", ParseError::errorInvalidEscape, 4);
+    expect("[\"ab\\ud800A\"]", ParseError::errorInvalidEscape, 4);
+    expect("[\"\\udc00\"]", ParseError::errorInvalidEscape, 2);
+    expect("[\"\\x4\"]", ParseError::errorInvalidEscape, 2);
+    expect("[\"\\x4g\"]", ParseError::errorInvalidEscape, 2);
+    expect("[\"a\xff\"]", ParseError::errorInvalidUtf8, 3);
+    expect("[\"ab\xc0\xaf\"]", ParseError::errorInvalidUtf8, 4);
+    expect("[\"\xed\xa0\x80\"]", ParseError::errorInvalidUtf8, 2);
+    expect(std::string("[\"ab\0c\"]", 8), ParseError::errorUnexpectedNull, 4);
+    expect("[\"abc", ParseError::errorUnexpectedEnd, 5);
+    expect("[\"ab\\", ParseError::errorUnexpectedEnd, 5);
+
+    // Quotes, escapes and multi-byte characters at every position of the
+    // sixteen byte runs.
+    for (Uint length = 0; length < 70; ++length)
+    {
+        std::string plain(length, 'x');
+        CHECK(decode("[\"" + plain + "\"]") == plain);
+        CHECK(decode("[\"" + plain + "\\\"\"]") == plain + "\"");
+        CHECK(decode("[\"" + plain + "\xc3\xa9" + plain + "\"]") == plain + "\xc3\xa9" + plain);
+        expect("[\"" + plain + "\xc3\"]", ParseError::errorInvalidUtf8, length + 2);
+    }
+
+    // Saving escapes what parsing decoded.
+    std::string original = "[\"quote \\\" backslash \\\\ newline \\n tab \\t bell \\u0007\", {\"k\\\"ey\": 1}]";
+    Value value;
+    Value again;
+    std::string saved;
+    std::string saved_again;
+
+    CHECK(value.parseString(original));
+    CHECK(value.saveToString(&saved));
+    CHECK(again.parseString(saved));
+    CHECK(again[0].asString() == "quote \" backslash \\ newline \n tab \t bell \x07");
+    CHECK(again.saveToString(&saved_again));
+    CHECK(saved_again == saved);
+    CHECK(saved.find("{\"k\\\"ey\": 1}") != std::string::npos);
+
+    return CHECK_RESULT();
+}
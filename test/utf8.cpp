@@ -0,0 +1,235 @@
+/*
+ * utf8.cpp
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <stdint.h>
+
+#include <string>
+
+#include <json/json.h>
+#include <json/jsonutf8.h>
+
+#include "check.h"
+
+using namespace json;
+
+namespace {
+
+uint64_t random_state = 0x9E3779B97F4A7C15ULL;
+
+uint64_t random64()
+{
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 7;
+    random_state ^= random_state << 17;
+    return random_state;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*
+ * The same check one sequence at a time, straight from RFC 3629.
+ */
+char const* referenceFind(char const* first, char const* last)
+{
+    unsigned char const* p = reinterpret_cast<unsigned char const*>(first);
+    unsigned char const* end = reinterpret_cast<unsigned char const*>(last);
+
+    while (p < end)
+    {
+        unsigned lead = *p;
+        int count;
+        unsigned code;
+        unsigned min;
+
+        if (lead < 0x80)
+        {
+            ++p;
+            continue;
+        }
+        else if (lead >= 0xC2 and lead <= 0xDF)
+        {
+            count = 1, code = lead & 0x1F, min = 0x80;
+        }
+        else if (lead >= 0xE0 and lead <= 0xEF)
+        {
+            count = 2, code = lead & 0x0F, min = 0x800;
+        }
+        else if (lead >= 0xF0 and lead <= 0xF4)
+        {
+            count = 3, code = lead & 0x07, min = 0x10000;
+        }
+        else
+        {
+            return reinterpret_cast<char const*>(p);
+        }
+
+        if (end - p <= count)
+            return reinterpret_cast<char const*>(p);
+
+        for (int ix = 1; ix <= count; ++ix)
+        {
+            if ((p[ix] & 0xC0) != 0x80)
+                return reinterpret_cast<char const*>(p);
+
+            code = (code << 6) | (p[ix] & 0x3F);
+        }
+
+        if (code < min or code > 0x10FFFF or (code >= 0xD800 and code <= 0xDFFF))
+            return reinterpret_cast<char const*>(p);
+
+        p += count + 1;
+    }
+
+    return null;
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void compare(std::string const& text)
+{
+    int failures = check_failures;
+    char const* first = text.data();
+    char const* last = first + text.size();
+    char const* expected = referenceFind(first, last);
+    char const* found = findInvalidUtf8(first, last);
+
+    CHECK(found == expected);
+
+    if (check_failures != failures)
+    {
+        fprintf(::stderr, "    size %u, expected %i, found %i\n", Uint(text.size()),
+                expected ? int(expected - first) : -1, found ? int(found - first) : -1);
+    }
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+std::string encode(unsigned code)
+{
+    std::string result;
+
+    if (code < 0x80)
+    {
+        result += char(code);
+    }
+    else if (code < 0x800)
+    {
+        result += char(0xC0 | (code >> 6));
+        result += char(0x80 | (code & 0x3F));
+    }
+    else if (code < 0x10000)
+    {
+        result += char(0xE0 | (code >> 12));
+        result += char(0x80 | ((code >> 6) & 0x3F));
+        result += char(0x80 | (code & 0x3F));
+    }
+    else
+    {
+        result += char(0xF0 | (code >> 18));
+        result += char(0x80 | ((code >> 12) & 0x3F));
+        result += char(0x80 | ((code >> 6) & 0x3F));
+        result += char(0x80 | (code & 0x3F));
+    }
+
+    return result;
+}
+
+} // namespace
+
+int main()
+{
+    // Well-formed text of every sequence length.
+    std::string valid;
+
+    for (unsigned code = 0; code < 0x110000; code += (code < 0x1000 ? 1 : 97))
+    {
+        if (code < 0xD800 or code > 0xDFFF)
+            valid += encode(code);
+    }
+
+    compare(valid);
+    CHECK(findInvalidUtf8(valid.data(), valid.data() + valid.size()) == null);
+
+    // Every kind of malformed sequence at every offset of the vector blocks,
+    // after ASCII and after multi-byte text.
+    char const* invalid[] = {
+        "\x80", "\xbf", "\xc0\x80", "\xc1\xbf", "\xe0\x80\x80", "\xe0\x9f\xbf", "\xed\xa0\x80", "\xed\xbf\xbf",
+        "\xf0\x80\x80\x80", "\xf0\x8f\xbf\xbf", "\xf4\x90\x80\x80", "\xf5\x80\x80\x80", "\xff", "\xfe",
+        "\xc3", "\xe2\x82", "\xf0\x9f\x98", "\xc3\x28", "\xe2\x28\xa1", "\xf0\x9f\x28\x80", "\xe2\x82\xac\x80",
+    };
+    std::string prefixes[] = { std::string(), "\xd0\xb9", "\xe2\x82\xac", "\xf0\x9f\x98\x80" };
+
+    for (char const* bad : invalid)
+    {
+        for (std::string const& prefix : prefixes)
+        {
+            for (Uint offset = 0; offset < 80; ++offset)
+            {
+                std::string text;
+
+                while (not prefix.empty() and text.size() + prefix.size() <= offset)
+                    text += prefix;
+
+                text += std::string(offset - text.size(), 'b');
+                compare(text + bad + std::string(100, 'c'));
+                compare(text + bad);
+                compare(text + bad + valid.substr(0, 300));
+            }
+        }
+    }
+
+    // Random bytes, mostly high ones, in runs of every length.
+    for (int round = 0; round < 20000; ++round)
+    {
+        std::string text;
+        Uint size = Uint(random64() % 200);
+
+        for (Uint ix = 0; ix < size; ++ix)
+        {
+            uint64_t r = random64();
+            text += r % 4 == 0 ? char(r >> 8) : (r % 4 == 1 ? char('a' + (r >> 8) % 26) : char(0x80 | ((r >> 8) & 0x3F)));
+        }
+
+        compare(text);
+
+        // Well-formed text with one byte replaced.
+        std::string mutated = valid.substr(random64() % 10000, 150);
+        mutated[random64() % mutated.size()] = char(random64());
+        compare(mutated);
+    }
+
+    // The parser reports the first bad byte of a long string.
+    for (Uint offset = 0; offset < 70; ++offset)
+    {
+        std::string text = "[\"" + std::string(offset, 'x') + "\xe2\x82\xac\xe2\x28\xa1" + std::string(40, 'y') + "\"]";
+        Value value;
+        ParseError error;
+
+        CHECK(not value.parseString(text, &error));
+        CHECK(error.code == ParseError::errorInvalidUtf8);
+        CHECK(error.offset == offset + 5);
+    }
+
+    return CHECK_RESULT();
+}
@@ -0,0 +1,199 @@
+/*
+ * validate.cpp
+ *
+ *  Created on: 17 окт. 2026 г.
+ *      Author: Voldemar Khramtsov <harestomper@gmail.com>
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+ * KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <string>
+
+#include <json/json.h>
+#include <json/jsonreader.h>
+#include <json/jsonvalidate.h>
+
+#include "check.h"
+
+using namespace json;
+
+namespace {
+
+struct NullHandler
+{
+    bool onNull() { return true; }
+    bool onBool(bool) { return true; }
+    bool onInteger(Integer) { return true; }
+    bool onDouble(double) { return true; }
+    bool onString(StringView) { return true; }
+    bool onKey(StringView) { return true; }
+    bool onStartObject() { return true; }
+    bool onEndObject() { return true; }
+    bool onStartArray() { return true; }
+    bool onEndArray() { return true; }
+};
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*
+ * validate() must agree with a Reader on the result, the error and where
+ * it is.
+ */
+template<typename Grammar>
+void compare(std::string const& text)
+{
+    int failures = check_failures;
+    NullHandler handler;
+    Reader<NullHandler, Grammar> reader(handler);
+    ParseError reader_error;
+    ParseError validate_error;
+
+    bool reader_ok = reader.parse(text.data(), text.data() + text.size(), &reader_error);
+    bool validate_ok = validate<Grammar>(text.data(), text.data() + text.size(), &validate_error);
+
+    CHECK(reader_ok == validate_ok);
+    CHECK(reader_error.code == validate_error.code);
+    CHECK(reader_error.offset == validate_error.offset);
+
+    if (check_failures != failures)
+        fprintf(::stderr, "    input: %s\n", text.c_str());
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*
+ * validate() with a depth limit must agree with a Reader given the same
+ * limit.
+ */
+void compareDepth(std::string const& text, Uint max_depth)
+{
+    int failures = check_failures;
+    NullHandler handler;
+    Reader<NullHandler, RelaxedGrammar> reader(handler);
+    ParseError reader_error;
+    ParseError validate_error;
+
+    reader.setMaxDepth(max_depth);
+
+    bool reader_ok = reader.parse(text.data(), text.data() + text.size(), &reader_error);
+    bool validate_ok = validate(text.data(), text.data() + text.size(), &validate_error, max_depth);
+
+    CHECK(reader_ok == validate_ok);
+    CHECK(reader_error.code == validate_error.code);
+    CHECK(reader_error.offset == validate_error.offset);
+
+    if (check_failures != failures)
+        fprintf(::stderr, "    depth %u, max_depth %u\n", Uint(text.size() / 2), max_depth);
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+std::string nested(Uint depth)
+{
+    return std::string(depth, '[') + std::string(depth, ']');
+}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*
+ * Arrays and objects mixed, so the kinds of the containers matter.
+ */
+std::string mixed(Uint depth)
+{
+    std::string text;
+
+    for (Uint ix = 0; ix < depth; ++ix)
+        text += (ix % 3 ? "[" : "{\"k\":");
+
+    text += "1";
+
+    for (Uint ix = depth; ix-- > 0;)
+        text += (ix % 3 ? "]" : "}");
+
+    return text;
+}
+
+} // namespace
+
+int main()
+{
+    char const* inputs[] = {
+        "{\"a\": [1, -2.5e-3, true, false, null, \"x\\u00e9\\n\"], \"b\": {}, \"c\": []}",
+        "  123  ", "\"top\"", "-0", "0x1F", "[1, /* c */ 2, // d\n 3,]", "{\"a\": 1,}",
+        "[\"\\x41\"]", "[\"a\tb\"]", "[1,\f2]", "", "   ", "[1, 2", "[1 2]", "{\"a\" 1}", "{1: 2}",
+        "[tru]", "[nul]", "[01]", "[1.]", "[1e]", "[-]", "[\"\\q\"]", "[\"\\ud800\"]", "[\"a\xff\"]",
+        "[\"\xed\xa0\x80\"]", "[\"abc", "[1]x", "[1,,2]", "[,1]", "{,}", "[1, /* open", "]", "}",
+        "[}", "{]",
+    };
+
+    for (char const* input : inputs)
+    {
+        compare<StrictGrammar>(input);
+        compare<RelaxedGrammar>(input);
+    }
+
+    // Every byte of a document, replaced by every interesting character.
+    std::string document = "{\"key\": [1, -2.5e+3, \"s\\\"t\\u0041r\", {\"n\": null, \"t\": true}], \"f\": false}";
+    char const replacements[] = "{}[],:\"\\/ 0-.eE+xtu\x01\xc3\xff";
+
+    for (Uint ix = 0; ix < document.size(); ++ix)
+    {
+        for (char c : std::string(replacements))
+        {
+            std::string mutated = document;
+            mutated[ix] = c;
+            compare<StrictGrammar>(mutated);
+            compare<RelaxedGrammar>(mutated);
+        }
+
+        compare<StrictGrammar>(document.substr(0, ix));
+        compare<RelaxedGrammar>(document.substr(0, ix));
+    }
+
+    // The depth is limited to JSON_MAX_DEPTH like everywhere else.
+    compare<RelaxedGrammar>(nested(JSON_MAX_DEPTH));
+    compare<RelaxedGrammar>(nested(JSON_MAX_DEPTH + 1));
+    compare<StrictGrammar>(nested(1000000));
+
+    std::string deepest = nested(JSON_MAX_DEPTH);
+    std::string deep = nested(JSON_MAX_DEPTH + 1);
+    ParseError error;
+
+    CHECK(validate(deepest.data(), deepest.data() + deepest.size()));
+    CHECK(not validate(deep.data(), deep.data() + deep.size(), &error));
+    CHECK(error.code == ParseError::errorDepthLimit);
+
+    // Other limits are applied the way Reader::setMaxDepth() applies them.
+    Uint limits[] = { 0, 1, 2, 63, 64, 65, 100, JSON_MAX_DEPTH, JSON_MAX_DEPTH + 1, 5000 };
+
+    for (Uint max_depth : limits)
+    {
+        compareDepth("1", max_depth);
+
+        for (Uint depth : { max_depth - 1, max_depth, max_depth + 1 })
+        {
+            if (depth <= 6000)
+                compareDepth(mixed(depth), max_depth);
+        }
+    }
+
+    std::string mixed_deep = mixed(JSON_MAX_DEPTH + 1);
+
+    CHECK(validate(mixed_deep.data(), mixed_deep.data() + mixed_deep.size(), null, JSON_MAX_DEPTH + 1));
+
+    return CHECK_RESULT();
+}